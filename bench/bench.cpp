@@ -1,10 +1,15 @@
 
 #include <transpose_tpl.hpp>
+#include <transpose_dispatch.hpp>
+#include <transpose_planner.hpp>
+#include <transpose_plan.hpp>
+#include <transpose_parallel.hpp>
 
 #include "transpose_ipp.hpp"
 #include "transpose_mkl.hpp"
 
 #include "matrix.hpp"
+#include "checks.hpp"
 
 #include <sys/time.h>
 #include <cstdint>
@@ -164,9 +169,23 @@ static inline bool have_AVX2() {
   return false;
 }
 
+static inline bool have_AVX512F() {
+  #if defined(CPU_FEATURES_ARCH_X86_64)
+    return have_AVX2() && cpufx.avx512f;
+  #endif
+  return false;
+}
+
+static inline bool have_NEON() {
+  #if defined(CPU_FEATURES_ARCH_AARCH64)
+    return cpufx.asimd;
+  #endif
+  return false;
+}
+
 HEDLEY_DIAGNOSTIC_POP
 
-// have_SSE() have_SSE2() have_SSSE3() have_SSE4() have_AVX() have_AVX2()
+// have_SSE() have_SSE2() have_SSSE3() have_SSE4() have_AVX() have_AVX2() have_AVX512F() have_NEON()
 
 
 ///////////////////////////////////////////
@@ -214,6 +233,52 @@ static void trans_fake(
 }
 
 
+// transpose through the planner, which measures at first call
+static transpose::planner bench_planner;
+
+template <class T, bool CONJUGATE>
+HEDLEY_NO_THROW
+static void trans_planned(
+  const transpose::mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+  const transpose::mat_info &out, NO_ESCAPE T * RESTRICT pout )
+{
+  bench_planner.transpose<T, CONJUGATE>( in, pin, out, pout );
+}
+
+// transpose with a plan, which is constructed at first call: the benchmark has only one shape
+template <class T, bool CONJUGATE>
+HEDLEY_NO_THROW
+static void trans_plan(
+  const transpose::mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+  const transpose::mat_info &out, NO_ESCAPE T * RESTRICT pout )
+{
+  static const transpose::plan<T, CONJUGATE> p( in, out );
+  p.execute( pin, pout );
+}
+
+// transpose with the 4 threads of a pool, which is started at first call
+template <class T, bool CONJUGATE>
+HEDLEY_NO_THROW
+static void trans_parallel(
+  const transpose::mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+  const transpose::mat_info &out, NO_ESCAPE T * RESTRICT pout )
+{
+  static transpose::thread_pool pool( 4 );
+  transpose::parallel_transpose<T, CONJUGATE>( in, pin, out, pout, pool );
+}
+
+// cache oblivious transpose with the 4 threads of a pool, which is started at first call
+template <class T, class U, bool CONJUGATE>
+HEDLEY_NO_THROW
+static void trans_parallel_co(
+  const transpose::mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+  const transpose::mat_info &out, NO_ESCAPE U * RESTRICT pout )
+{
+  static transpose::thread_pool pool( 4 );
+  transpose::parallel_cache_oblivious_meta<T, U, CONJUGATE>( in, pin, out, pout, pool );
+}
+
+
 struct test_s
 {
   const char * n;
@@ -224,7 +289,7 @@ struct test_s
   bool cj;
 };
 
-static test_s tests[32];
+static test_s tests[64];
 static int n_tests = 0;
 
 //////////////////////////////////////////////////////
@@ -324,12 +389,18 @@ static void enqueue_versatile_tests(
   enqueue( "cache_oblivious_in        ", transpose::cache_oblivious_in  <DTYPEX, DTYPEY> );
   enqueue( "cache_oblivious_out       ", transpose::cache_oblivious_out <DTYPEX, DTYPEY> );
   enqueue( "cache_oblivious_meta      ", transpose::cache_oblivious_meta<DTYPEX, DTYPEY> );
+  enqueue( "cache_oblivious_meta<4 th>", trans_parallel_co<DTYPEX, DTYPEY, false> );
 
   enqueue( "cache_aware_in            ", transpose::caware_in<  DTYPEX, DTYPEY> );
   enqueue( "cache_aware_out           ", transpose::caware_out< DTYPEX, DTYPEY> );
   enqueue( "cache_aware_meta          ", transpose::caware_meta<DTYPEX, DTYPEY> );
 
 #if SAME_DTYPE_SIZES
+  enqueue( "transpose  <dispatch>     ", transpose::transpose<DTYPEX> );
+  enqueue( "transpose  <planner>      ", trans_planned<DTYPEX, false> );
+  enqueue( "plan       <dispatch>     ", trans_plan<DTYPEX, false> );
+  enqueue( "parallel   <4 threads>    ", trans_parallel<DTYPEX, false> );
+
   using TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::Naive4x4Kernel<DTYPEX> >;
   enqueue( "kernel_in  <naive>_uu     ", TRANSPOSE_CLASS::uu_in );
   enqueue( "kernel_out <naive>_uu     ", TRANSPOSE_CLASS::uu_out );
@@ -367,6 +438,30 @@ static void enqueue_8bit_tests(
      }
 #  endif
 
+#  ifdef HAVE_AVX2_16X16X8_KERNEL
+     if ( have_AVX2() ) {
+       using TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::AVX2_16x16x8Kernel<DTYPEX, false> >;
+       enqueue( "kernel_in  <AVX2_16x16>_uu", TRANSPOSE_CLASS::uu_in );
+       enqueue( "kernel_out <AVX2_16x16>_uu", TRANSPOSE_CLASS::uu_out );
+       if ( TRANSPOSE_CLASS::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <AVX2_16x16>_aa", TRANSPOSE_CLASS::aa_in );
+         enqueue( "kernel_out <AVX2_16x16>_aa", TRANSPOSE_CLASS::aa_out );
+       }
+     }
+#  endif
+
+#  ifdef HAVE_NEON_16X16X8_KERNEL
+     if ( have_NEON() ) {
+       using NEON_TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::NEON_16x16x8Kernel<DTYPEX, false> >;
+       enqueue( "kernel_in  <NEON_16x16>_uu", NEON_TRANSPOSE_CLASS::uu_in );
+       enqueue( "kernel_out <NEON_16x16>_uu", NEON_TRANSPOSE_CLASS::uu_out );
+       if ( NEON_TRANSPOSE_CLASS::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <NEON_16x16>_aa", NEON_TRANSPOSE_CLASS::aa_in );
+         enqueue( "kernel_out <NEON_16x16>_aa", NEON_TRANSPOSE_CLASS::aa_out );
+       }
+     }
+#  endif
+
 #  if defined(HAVE_ONEAPI_IPP)
      transpose::ipp_single_thread(verbose);
 #    if defined(HAVE_IPP_KERNEL)
@@ -398,6 +493,32 @@ static void enqueue_16bit_tests(
          enqueue( "kernel_in  <SSE2_8x8>_aa  ", TRANSPOSE_CLASS::aa_in );
          enqueue( "kernel_out <SSE2_8x8>_aa  ", TRANSPOSE_CLASS::aa_out );
        }
+       enqueue( "kernel_in  <SSE2_8x8>_pf2 ", TRANSPOSE_CLASS::pf_in<2, false> );
+       enqueue( "kernel_out <SSE2_8x8>_pf8 ", TRANSPOSE_CLASS::pf_out<8, false> );
+     }
+#  endif
+
+#  ifdef HAVE_AVX2_16X16X16_KERNEL
+     if ( have_AVX2() ) {
+       using AVX2_TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::AVX2_16x16x16Kernel<DTYPEX, false> >;
+       enqueue( "kernel_in  <AVX2_16x16>_uu", AVX2_TRANSPOSE_CLASS::uu_in );
+       enqueue( "kernel_out <AVX2_16x16>_uu", AVX2_TRANSPOSE_CLASS::uu_out );
+       if ( AVX2_TRANSPOSE_CLASS::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <AVX2_16x16>_aa", AVX2_TRANSPOSE_CLASS::aa_in );
+         enqueue( "kernel_out <AVX2_16x16>_aa", AVX2_TRANSPOSE_CLASS::aa_out );
+       }
+     }
+#  endif
+
+#  ifdef HAVE_NEON_8X8X16_KERNEL
+     if ( have_NEON() ) {
+       using NEON_TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::NEON_8x8x16Kernel<DTYPEX, false> >;
+       enqueue( "kernel_in  <NEON_8x8>_uu  ", NEON_TRANSPOSE_CLASS::uu_in );
+       enqueue( "kernel_out <NEON_8x8>_uu  ", NEON_TRANSPOSE_CLASS::uu_out );
+       if ( NEON_TRANSPOSE_CLASS::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <NEON_8x8>_aa  ", NEON_TRANSPOSE_CLASS::aa_in );
+         enqueue( "kernel_out <NEON_8x8>_aa  ", NEON_TRANSPOSE_CLASS::aa_out );
+       }
      }
 #  endif
 
@@ -459,6 +580,8 @@ static void enqueue_32bit_tests(
          enqueue( "kernel_in  <AVX_8x8>_aa   ", AVX88_TRANSPOSE_CLASS::aa_in );
          enqueue( "kernel_out <AVX_8x8>_aa   ", AVX88_TRANSPOSE_CLASS::aa_out );
        }
+       enqueue( "kernel_in  <AVX_8x8>_pf2  ", AVX88_TRANSPOSE_CLASS::pf_in<2, false> );
+       enqueue( "kernel_out <AVX_8x8>_pf8  ", AVX88_TRANSPOSE_CLASS::pf_out<8, false> );
      }
 
      if ( have_AVX() ) {
@@ -472,6 +595,32 @@ static void enqueue_32bit_tests(
      }
 #  endif
 
+#  ifdef HAVE_AVX512_16X16X32_KERNEL
+     if ( have_AVX512F() ) {
+       using AVX512_TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::AVX512_16x16x32Kernel<DTYPEX> >;
+       enqueue( "kernel_in  <AVX512_16>_uu ", AVX512_TRANSPOSE_CLASS::uu_in );
+       enqueue( "kernel_out <AVX512_16>_uu ", AVX512_TRANSPOSE_CLASS::uu_out );
+       if ( AVX512_TRANSPOSE_CLASS::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <AVX512_16>_aa ", AVX512_TRANSPOSE_CLASS::aa_in );
+         enqueue( "kernel_out <AVX512_16>_aa ", AVX512_TRANSPOSE_CLASS::aa_out );
+         enqueue( "kernel_in  <AVX512_16>_nt ", AVX512_TRANSPOSE_CLASS::nt_in );
+         enqueue( "kernel_out <AVX512_16>_nt ", AVX512_TRANSPOSE_CLASS::nt_out );
+       }
+     }
+#  endif
+
+#  ifdef HAVE_NEON_4X4X32_KERNEL
+     if ( have_NEON() ) {
+       using NEON_TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::NEON_4x4x32Kernel<DTYPEX, false> >;
+       enqueue( "kernel_in  <NEON_4x4>_uu  ", NEON_TRANSPOSE_CLASS::uu_in );
+       enqueue( "kernel_out <NEON_4x4>_uu  ", NEON_TRANSPOSE_CLASS::uu_out );
+       if ( NEON_TRANSPOSE_CLASS::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <NEON_4x4>_aa  ", NEON_TRANSPOSE_CLASS::aa_in );
+         enqueue( "kernel_out <NEON_4x4>_aa  ", NEON_TRANSPOSE_CLASS::aa_out );
+       }
+     }
+#  endif
+
 #  ifdef HAVE_MKL_KERNEL
      transpose::mkl_single_thread(verbose);
 #    if defined(HAVE_SYSTEM_MKL)
@@ -505,6 +654,26 @@ static void enqueue_64bit_tests(
 {
 #if SAME_DTYPE_SIZES && DTYPEX_SZ == 8
 
+#  ifdef HAVE_SSE2_4X4X64_KERNEL
+     if ( have_SSE2() ) {
+       using TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::SSE2_4x4x64Kernel<DTYPEX, false> >;
+       enqueue( "kernel_in  <SSE2_4x4>_uu  ", TRANSPOSE_CLASS::uu_in );
+       enqueue( "kernel_out <SSE2_4x4>_uu  ", TRANSPOSE_CLASS::uu_out );
+       if ( TRANSPOSE_CLASS::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <SSE2_4x4>_aa  ", TRANSPOSE_CLASS::aa_in );
+         enqueue( "kernel_out <SSE2_4x4>_aa  ", TRANSPOSE_CLASS::aa_out );
+       }
+
+       using TRANSPOSE_CJ_CL = transpose::caware_kernel<DTYPEX, true, transpose_kernels::SSE2_4x4x64Kernel<DTYPEX, true> >;
+       enqueue( "kernel_in  <SSE2_4x4>_uucj", TRANSPOSE_CJ_CL::uu_in, true );
+       enqueue( "kernel_out <SSE2_4x4>_uucj", TRANSPOSE_CJ_CL::uu_out, true );
+       if ( TRANSPOSE_CJ_CL::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <SSE2_4x4>_aacj", TRANSPOSE_CJ_CL::aa_in, true );
+         enqueue( "kernel_out <SSE2_4x4>_aacj", TRANSPOSE_CJ_CL::aa_out, true );
+       }
+     }
+#  endif
+
 #  ifdef HAVE_AVX_4X4X64_KERNEL
      if ( have_AVX() ) {
        using TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::AVX_4x4x64Kernel<DTYPEX, false> >;
@@ -525,6 +694,54 @@ static void enqueue_64bit_tests(
      }
 #  endif
 
+#  ifdef HAVE_AVX512_8X8X64_KERNEL
+     if ( have_AVX512F() ) {
+       using TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::AVX512_8x8x64Kernel<DTYPEX, false> >;
+       enqueue( "kernel_in  <AVX512_8>_uu  ", TRANSPOSE_CLASS::uu_in );
+       enqueue( "kernel_out <AVX512_8>_uu  ", TRANSPOSE_CLASS::uu_out );
+       if ( TRANSPOSE_CLASS::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <AVX512_8>_aa  ", TRANSPOSE_CLASS::aa_in );
+         enqueue( "kernel_out <AVX512_8>_aa  ", TRANSPOSE_CLASS::aa_out );
+         enqueue( "kernel_in  <AVX512_8>_nt  ", TRANSPOSE_CLASS::nt_in );
+         enqueue( "kernel_out <AVX512_8>_nt  ", TRANSPOSE_CLASS::nt_out );
+       }
+
+       using TRANSPOSE_CJ_CL = transpose::caware_kernel<DTYPEX, true, transpose_kernels::AVX512_8x8x64Kernel<DTYPEX, true> >;
+       enqueue( "kernel_in  <AVX512_8>_uucj", TRANSPOSE_CJ_CL::uu_in, true );
+       enqueue( "kernel_out <AVX512_8>_uucj", TRANSPOSE_CJ_CL::uu_out, true );
+       if ( TRANSPOSE_CJ_CL::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <AVX512_8>_aacj", TRANSPOSE_CJ_CL::aa_in, true );
+         enqueue( "kernel_out <AVX512_8>_aacj", TRANSPOSE_CJ_CL::aa_out, true );
+         enqueue( "kernel_in  <AVX512_8>_ntcj", TRANSPOSE_CJ_CL::nt_in, true );
+         enqueue( "kernel_out <AVX512_8>_ntcj", TRANSPOSE_CJ_CL::nt_out, true );
+       }
+     }
+#  endif
+
+#  ifdef HAVE_NEON_4X4X64_KERNEL
+     if ( have_NEON() ) {
+       using NEON_TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::NEON_4x4x64Kernel<DTYPEX, false> >;
+       enqueue( "kernel_in  <NEON_4x4>_uu  ", NEON_TRANSPOSE_CLASS::uu_in );
+       enqueue( "kernel_out <NEON_4x4>_uu  ", NEON_TRANSPOSE_CLASS::uu_out );
+       if ( NEON_TRANSPOSE_CLASS::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <NEON_4x4>_aa  ", NEON_TRANSPOSE_CLASS::aa_in );
+         enqueue( "kernel_out <NEON_4x4>_aa  ", NEON_TRANSPOSE_CLASS::aa_out );
+       }
+
+       using NEON_TRANSPOSE_CJ_CL = transpose::caware_kernel<DTYPEX, true, transpose_kernels::NEON_4x4x64Kernel<DTYPEX, true> >;
+       enqueue( "kernel_in  <NEON_4x4>_uucj", NEON_TRANSPOSE_CJ_CL::uu_in, true );
+       enqueue( "kernel_out <NEON_4x4>_uucj", NEON_TRANSPOSE_CJ_CL::uu_out, true );
+       if ( NEON_TRANSPOSE_CJ_CL::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <NEON_4x4>_aacj", NEON_TRANSPOSE_CJ_CL::aa_in, true );
+         enqueue( "kernel_out <NEON_4x4>_aacj", NEON_TRANSPOSE_CJ_CL::aa_out, true );
+       }
+     }
+#  endif
+
+     enqueue( "transpose  <dispatch>   cj", transpose::transpose<DTYPEX, true>, true );
+     enqueue( "transpose  <planner>    cj", trans_planned<DTYPEX, true>, true );
+     enqueue( "plan       <dispatch>   cj", trans_plan<DTYPEX, true>, true );
+
 #  ifdef HAVE_MKL_KERNEL
      transpose::mkl_single_thread(verbose);
 #    if defined(HAVE_SYSTEM_MKL)
@@ -551,6 +768,30 @@ static void enqueue_128bit_tests(
 {
 #if SAME_DTYPE_SIZES && DTYPEX_SZ == 16
 
+#  ifdef HAVE_SSE2_4X4X128_KERNEL
+     if ( have_SSE2() ) {
+       using TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::SSE2_4x4x128Kernel<DTYPEX, false> >;
+       enqueue( "kernel_in  <SSE2_4cd>_uu  ", TRANSPOSE_CLASS::uu_in );
+       enqueue( "kernel_out <SSE2_4cd>_uu  ", TRANSPOSE_CLASS::uu_out );
+       if ( TRANSPOSE_CLASS::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <SSE2_4cd>_aa  ", TRANSPOSE_CLASS::aa_in );
+         enqueue( "kernel_out <SSE2_4cd>_aa  ", TRANSPOSE_CLASS::aa_out );
+         enqueue( "kernel_in  <SSE2_4cd>_nt  ", TRANSPOSE_CLASS::nt_in );
+         enqueue( "kernel_out <SSE2_4cd>_nt  ", TRANSPOSE_CLASS::nt_out );
+       }
+
+       using TRANSPOSE_CJ_CL = transpose::caware_kernel<DTYPEX, true, transpose_kernels::SSE2_4x4x128Kernel<DTYPEX, true> >;
+       enqueue( "kernel_in  <SSE2_4cd>_uucj", TRANSPOSE_CJ_CL::uu_in, true );
+       enqueue( "kernel_out <SSE2_4cd>_uucj", TRANSPOSE_CJ_CL::uu_out, true );
+       if ( TRANSPOSE_CJ_CL::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <SSE2_4cd>_aacj", TRANSPOSE_CJ_CL::aa_in, true );
+         enqueue( "kernel_out <SSE2_4cd>_aacj", TRANSPOSE_CJ_CL::aa_out, true );
+         enqueue( "kernel_in  <SSE2_4cd>_ntcj", TRANSPOSE_CJ_CL::nt_in, true );
+         enqueue( "kernel_out <SSE2_4cd>_ntcj", TRANSPOSE_CJ_CL::nt_out, true );
+       }
+     }
+#  endif
+
 #  ifdef HAVE_AVX_4X4X128_KERNEL
      if ( have_AVX() ) {
        using TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::AVX_4x4x128Kernel<DTYPEX, false> >;
@@ -571,6 +812,34 @@ static void enqueue_128bit_tests(
      }
 #  endif
 
+#  ifdef HAVE_AVX512_4X4X128_KERNEL
+     if ( have_AVX512F() ) {
+       using TRANSPOSE_CLASS = transpose::caware_kernel<DTYPEX, false, transpose_kernels::AVX512_4x4x128Kernel<DTYPEX, false> >;
+       enqueue( "kernel_in  <AVX512_4cd>_uu", TRANSPOSE_CLASS::uu_in );
+       enqueue( "kernel_out <AVX512_4cd>_uu", TRANSPOSE_CLASS::uu_out );
+       if ( TRANSPOSE_CLASS::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in  <AVX512_4cd>_aa", TRANSPOSE_CLASS::aa_in );
+         enqueue( "kernel_out <AVX512_4cd>_aa", TRANSPOSE_CLASS::aa_out );
+         enqueue( "kernel_in  <AVX512_4cd>_nt", TRANSPOSE_CLASS::nt_in );
+         enqueue( "kernel_out <AVX512_4cd>_nt", TRANSPOSE_CLASS::nt_out );
+       }
+
+       using TRANSPOSE_CJ_CL = transpose::caware_kernel<DTYPEX, true, transpose_kernels::AVX512_4x4x128Kernel<DTYPEX, true> >;
+       enqueue( "kernel_in <AVX512_4c>_uucj", TRANSPOSE_CJ_CL::uu_in, true );
+       enqueue( "kernel_out<AVX512_4c>_uucj", TRANSPOSE_CJ_CL::uu_out, true );
+       if ( TRANSPOSE_CJ_CL::aa_possible(in, pin, out, pout) ) {
+         enqueue( "kernel_in <AVX512_4c>_aacj", TRANSPOSE_CJ_CL::aa_in, true );
+         enqueue( "kernel_out<AVX512_4c>_aacj", TRANSPOSE_CJ_CL::aa_out, true );
+         enqueue( "kernel_in <AVX512_4c>_ntcj", TRANSPOSE_CJ_CL::nt_in, true );
+         enqueue( "kernel_out<AVX512_4c>_ntcj", TRANSPOSE_CJ_CL::nt_out, true );
+       }
+     }
+#  endif
+
+     enqueue( "transpose  <dispatch>   cj", transpose::transpose<DTYPEX, true>, true );
+     enqueue( "transpose  <planner>    cj", trans_planned<DTYPEX, true>, true );
+     enqueue( "plan       <dispatch>   cj", trans_plan<DTYPEX, true>, true );
+
 #  ifdef HAVE_MKL_KERNEL
      transpose::mkl_single_thread(verbose);
 #    if defined(HAVE_SYSTEM_MKL)
@@ -667,7 +936,12 @@ int main( int argc, char* argv[] ) {
 #else
     const char maxSIMD[] = "no x86 SIMD available";
 #endif
-    std::cout << "maximum supported SIMD at compile time: " << maxSIMD << "\n\n";
+    std::cout << "maximum supported SIMD at compile time: " << maxSIMD << "\n";
+#if SAME_DTYPE_SIZES
+    const transpose::dispatch_entry * dispatched = transpose::dispatch_select( sizeof(DTYPEX), false );
+    std::cout << "kernel selected at runtime by dispatch: " << ( dispatched ? dispatched->name : "none" ) << "\n";
+#endif
+    std::cout << "\n";
   }
 
   in.init();
@@ -676,6 +950,14 @@ int main( int argc, char* argv[] ) {
     in.print<DTYPEP>();
   }
 
+#if SAME_DTYPE_SIZES
+  // checks with their own shapes
+  if ( run_checks<DTYPEX>() )
+    std::cerr << n_check_errors << " checks failed\n";
+  else if (verbose >= 1)
+    std::cout << "all checks passed\n";
+#endif
+
   transpose::mat_info in_info  {  in.nRows,  in.nCols,  in.rowSize };
   transpose::mat_info out_info { out.nRows, out.nCols, out.rowSize };
   enqueue_versatile_tests(in_info, in.data, out_info, out.data);
@@ -711,6 +993,14 @@ int main( int argc, char* argv[] ) {
           << std::scientific << std::setprecision(2) << tests[min_idx].cycles << " cycles\n";
       }
     }
+
+#if SAME_DTYPE_SIZES
+    if (verbose >= 1) {
+      const char * planned = nullptr;
+      bench_planner.plan<DTYPEX>( in_info, in.data, out_info, out.data, &planned );
+      std::cout << "algorithm selected by planner: " << ( planned ? planned : "none" ) << "\n";
+    }
+#endif
   }
 
 #if SAME_DTYPE_SIZES && DTYPEX_SZ == 4
@@ -900,5 +1190,5 @@ int main( int argc, char* argv[] ) {
 #endif
 #endif
 
-  return 0;
+  return n_check_errors ? 1 : 0;
 }
@@ -0,0 +1,451 @@
+#pragma once
+
+// checks of the library's higher level functions with fixed shapes - independent of the benchmarked matrix:
+//   each result gets compared element-wise with it's expectation. mismatches get reported on std::cerr
+
+#include <transpose_batch.hpp>
+#include <transpose_defs.hpp>
+#include <transpose_dispatch.hpp>
+#include <transpose_inplace.hpp>
+#include <transpose_layout.hpp>
+#include <transpose_padding.hpp>
+#include <transpose_parallel.hpp>
+#include <transpose_permute.hpp>
+
+#include <cassert>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+
+static int n_check_errors = 0;
+
+// reports a failed check with it's name and the shape parameters
+template <class... ARGS>
+static void check( const bool ok, const char * name, const ARGS &... args )
+{
+  if ( ok )
+    return;
+  ++n_check_errors;
+  std::cerr << "error at check of " << name << ":";
+  ( ( std::cerr << " " << args ), ... );
+  std::cerr << "\n";
+  assert( 0 );
+}
+
+// non-zero value of element k - distinct for the first 126 elements with 8 bit types
+template <class T>
+static T check_value( const std::size_t k )
+{
+  if constexpr ( std::is_same<T, std::complex<float> >::value || std::is_same<T, std::complex<double> >::value )
+    return T( typename T::value_type( k % 65521 + 1 ), typename T::value_type( k & 7 ) );
+  else
+    return T( k % std::size_t( std::numeric_limits<T>::max() - 1 ) + 1 );
+}
+
+template <class T>
+static void check_fill( T * p, const std::size_t n, const std::size_t first = 0 )
+{
+  for ( std::size_t k = 0; k < n; ++k )
+    p[k] = check_value<T>( first + k );
+}
+
+// pout holds the transpose of the nRows x nCols matrix at pin? row sizes in elements
+template <class T>
+static bool check_transposed(
+  const unsigned nRows, const unsigned nCols,
+  const T * pin, const std::size_t inRowSize,
+  const T * pout, const std::size_t outRowSize )
+{
+  for ( unsigned r = 0; r < nRows; ++r )
+    for ( unsigned c = 0; c < nCols; ++c )
+      if ( pout[c * outRowSize + r] != pin[r * inRowSize + c] )
+        return false;
+  return true;
+}
+
+
+// n elements at offset elements beyond a 64 byte boundary
+template <class T>
+struct check_buffer
+{
+  check_buffer( const std::size_t n, const unsigned offset )
+    : v( n + offset + 64 / sizeof(T) + 1 )
+  {
+    const std::uintptr_t a = reinterpret_cast<std::uintptr_t>( v.data() );
+    p = v.data() + ( ( 64 - a % 64 ) % 64 ) / sizeof(T) + offset;
+  }
+
+  std::vector<T> v;
+  T * p;
+};
+
+
+// padded_matrix / calc_padded_row_size(): beyond L1, the padded row size is an odd number of lines, which keep
+//   the alignment - and is at least nCols. the matrices get allocated with it and transposed
+template <class T>
+static void check_padding()
+{
+  static constexpr unsigned shapes[][2] = { { 1024, 1024 }, { 512, 2048 }, { 300, 1000 }, { 77, 3 }, { 8, 8 } };
+  for ( unsigned lineSize : { 64U, 128U } ) {
+    for ( const auto &s : shapes ) {
+      const unsigned rs = transpose::calc_padded_row_size( sizeof(T), s[0], s[1], lineSize, 32768 );
+      const std::size_t bytes = std::size_t(rs) * sizeof(T);
+      const bool l1 = ( std::size_t(s[0]) * s[1] * sizeof(T) <= 32768 );
+      check( rs >= s[1] && !( bytes % lineSize ) && ( l1 || ( ( bytes / lineSize ) & 1 ) ),
+        "calc_padded_row_size", s[0], s[1], lineSize, rs );
+    }
+  }
+
+  for ( const auto &s : shapes ) {
+    transpose::padded_matrix<T> in( s[0], s[1] ), out( s[1], s[0] );
+    const bool alloc = in.data && out.data;
+    check( alloc && !( reinterpret_cast<std::uintptr_t>( in.data ) % 64 ) && !( reinterpret_cast<std::uintptr_t>( out.data ) % 64 )
+      && in.info.rowSize == transpose::padded_row_size<T>( s[0], s[1] ), "padded_matrix", s[0], s[1] );
+    if ( !alloc )
+      continue;
+    for ( unsigned r = 0; r < s[0]; ++r )
+      check_fill( in.row( r ), s[1], std::size_t(r) * s[1] );
+    transpose::transpose<T>( in.info, in.data, out.info, out.data );
+    check( check_transposed( s[0], s[1], in.data, in.info.rowSize, out.data, out.info.rowSize ),
+      "transpose of padded_matrix", s[0], s[1] );
+  }
+}
+
+
+// parallel_transpose() on a pool of 4 threads: odd shapes - and row sizes in multiples of 64 elements
+//   with aligned buffers (offset 0) or buffers for peeling to the aligned kernel (offset 1)
+template <class T>
+static void check_parallel()
+{
+  static constexpr unsigned shapes[][2] = { { 512, 768 }, { 1000, 999 }, { 37, 1001 }, { 1031, 65 }, { 513, 257 }, { 5, 3 } };
+  transpose::thread_pool pool( 4 );
+  for ( const auto &s : shapes ) {
+    for ( unsigned offset : { 0U, 1U } ) {
+      for ( bool pad : { false, true } ) {
+        const unsigned rsIn = pad ? ( s[1] + 63 ) / 64 * 64 : s[1], rsOut = pad ? ( s[0] + 63 ) / 64 * 64 : s[0];
+        const std::size_t nIn = std::size_t(s[0]) * rsIn, nOut = std::size_t(s[1]) * rsOut;
+        check_buffer<T> in( nIn, offset ), out( nOut, offset );
+        check_fill( in.p, nIn );
+        transpose::parallel_transpose<T>( transpose::mat_info { s[0], s[1], rsIn }, in.p,
+          transpose::mat_info { s[1], s[0], rsOut }, out.p, pool );
+        check( check_transposed( s[0], s[1], in.p, rsIn, out.p, rsOut ), "parallel_transpose", s[0], s[1], rsIn, rsOut, offset );
+      }
+    }
+  }
+}
+
+
+// parallel_cache_oblivious_meta() / _in() / _out() on a pool of 4 threads: shapes above and below
+//   the task cutoff of 64 x 64 elements - in both orders
+template <class T>
+static void check_parallel_co()
+{
+  static constexpr unsigned shapes[][2] = { { 700, 500 }, { 333, 1201 }, { 1201, 333 }, { 65, 63 }, { 7, 9 } };
+  transpose::thread_pool pool( 4 );
+  for ( const auto &s : shapes ) {
+    const transpose::mat_info in { s[0], s[1], s[1] + 3 }, out { s[1], s[0], s[0] + 1 };
+    std::vector<T> a( std::size_t(in.nRows) * in.rowSize ), b( std::size_t(out.nRows) * out.rowSize );
+    check_fill( a.data(), a.size() );
+    for ( unsigned order = 0; order < 3; ++order ) {
+      if ( order == 0 )
+        transpose::parallel_cache_oblivious_meta<T, T>( in, a.data(), out, b.data(), pool );
+      else if ( order == 1 )
+        transpose::parallel_cache_oblivious_in<T, T>( in, a.data(), out, b.data(), pool );
+      else
+        transpose::parallel_cache_oblivious_out<T, T>( in, a.data(), out, b.data(), pool );
+      check( check_transposed( s[0], s[1], a.data(), in.rowSize, b.data(), out.rowSize ),
+        "parallel_cache_oblivious", s[0], s[1], order );
+    }
+  }
+}
+
+
+// NUMA pool of 4 threads: first_touch() keeps the contents - and parallel_transpose() in output order.
+//   without NUMA nodes, the pool has a single node
+template <class T>
+static void check_numa()
+{
+  static constexpr unsigned shapes[][2] = { { 1000, 999 }, { 37, 1001 }, { 2048, 24 } };
+  transpose::thread_pool pool( 4, true );
+  bool nodes = ( pool.num_nodes() >= 1 );
+  for ( unsigned t = 0; t < pool.size(); ++t )
+    nodes = nodes && ( pool.thread_node( t ) < pool.num_nodes() );
+  check( nodes, "NUMA thread_pool nodes", pool.size(), pool.num_nodes() );
+  for ( const auto &s : shapes ) {
+    const transpose::mat_info in { s[0], s[1], s[1] }, out { s[1], s[0], s[0] + 5 };
+    std::vector<T> a( std::size_t(in.nRows) * in.rowSize ), b( std::size_t(out.nRows) * out.rowSize );
+    check_fill( a.data(), a.size() );
+    check_fill( b.data(), b.size(), 7 );
+    transpose::first_touch<T>( out, b.data(), pool );
+    bool kept = true;
+    for ( std::size_t k = 0; k < b.size(); ++k )
+      kept = kept && ( b[k] == check_value<T>( 7 + k ) );
+    check( kept, "first_touch", s[1], s[0] );
+    transpose::parallel_transpose<T>( in, a.data(), out, b.data(), pool );
+    check( check_transposed( s[0], s[1], a.data(), in.rowSize, b.data(), out.rowSize ), "parallel_transpose with NUMA pool", s[0], s[1] );
+  }
+}
+
+
+// transpose_inplace() and parallel_transpose_inplace() on a pool of 4 threads: n below, at and above the kernel size
+//   and beyond one chunk of tile pairs. row sizes unpadded, padded to a multiple of the kernel size - or odd.
+//   with offset 0 and a row size in multiples of the kernel size, inplace_square_kernel() picks the aligned kernel.
+//   the padding must stay untouched
+template <class T>
+static void check_inplace()
+{
+  transpose::thread_pool pool( 4 );
+  const check_buffer<T> probe( 1, 0 );
+  bool aligned = false;
+  const transpose::dispatch_entry * e = transpose::inplace_square_kernel<T, false>( probe.p, 64, aligned );
+  const unsigned K = e ? e->kernel_sz : 8;
+  for ( unsigned n : { 1U, K - 1, K, K + 1, 3 * K + 5, ( transpose::INPLACE_CHUNK + 2 ) * K + 3 } ) {
+    for ( unsigned offset : { 0U, 1U } ) {
+      for ( unsigned rs : { n, ( n + K - 1 ) / K * K + K, n + 3 } ) {
+        const std::size_t nElems = std::size_t(n) * rs;
+        check_buffer<T> buf( nElems, offset );
+        if ( e ) {
+          transpose::inplace_square_kernel<T, false>( buf.p, rs, aligned );
+          const bool expected = e->tiles_aa_out && !offset && !( rs % K );
+          check( aligned == expected, "inplace_square_kernel aligned", n, rs, offset, aligned );
+        }
+        for ( bool parallel : { false, true } ) {
+          check_fill( buf.p, nElems );
+          const std::vector<T> orig( buf.p, buf.p + nElems );
+          if ( parallel )
+            transpose::parallel_transpose_inplace<T>( n, buf.p, rs, pool );
+          else
+            transpose::transpose_inplace<T>( n, buf.p, rs );
+          bool padding = true;
+          for ( std::size_t r = 0; r < n; ++r )
+            for ( std::size_t c = n; c < rs; ++c )
+              padding = padding && ( buf.p[r * rs + c] == orig[r * rs + c] );
+          check( check_transposed( n, n, orig.data(), rs, buf.p, rs ) && padding,
+            parallel ? "parallel_transpose_inplace" : "transpose_inplace", n, rs, offset );
+        }
+      }
+    }
+  }
+}
+
+
+// transpose_inplace_rect(): gcd( m, n ) > 1 and gcd = 1, m < n and m > n - with the default scratch
+//   and with a scratch of 1 byte, which forces blocks of a single column
+template <class T>
+static void check_inplace_rect()
+{
+  static constexpr unsigned shapes[][2] = { { 6, 4 }, { 4, 6 }, { 12, 18 }, { 7, 5 }, { 13, 29 }, { 300, 200 }, { 97, 1000 }, { 1, 9 } };
+  for ( const auto &s : shapes ) {
+    const std::size_t nElems = std::size_t(s[0]) * s[1];
+    for ( std::size_t scratchBytes : { std::size_t(0), std::size_t(1) } ) {
+      std::vector<T> a( nElems );
+      check_fill( a.data(), a.size() );
+      const std::vector<T> orig( a );
+      const bool ok = transpose::transpose_inplace_rect<T>( s[0], s[1], a.data(), scratchBytes );
+      check( ok && check_transposed( s[0], s[1], orig.data(), s[1], a.data(), s[0] ),
+        "transpose_inplace_rect", s[0], s[1], scratchBytes );
+    }
+  }
+}
+
+
+// transpose_batch() with strides: contiguous tiny matrices - several per row of the transpose across matrices -
+//   gapped strides, and matrices beyond the kernel size, which get the plan. a batch size, which leaves a
+//   remainder of matrices. the pointer-array overload with padded row sizes and matrices in reverse order
+template <class T>
+static void check_batch()
+{
+  static constexpr unsigned shapes[][2] = { { 2, 3 }, { 1, 5 }, { 3, 3 }, { 4, 9 }, { 7, 40 }, { 40, 33 } };
+  const unsigned nBatch = 1001;
+  for ( const auto &s : shapes ) {
+    const unsigned RC = s[0] * s[1];
+    for ( unsigned gap : { 0U, 5U } ) {
+      const std::size_t inStride = RC + gap, outStride = RC + 2 * gap;
+      const std::size_t nIn = inStride * nBatch, nOut = outStride * nBatch;
+      std::vector<T> a( nIn ), b( nOut );
+      check_fill( a.data(), a.size() );
+      transpose::transpose_batch<T>( transpose::mat_info { s[0], s[1], s[1] }, a.data(), inStride,
+        transpose::mat_info { s[1], s[0], s[0] }, b.data(), outStride, nBatch );
+      bool ok = true;
+      for ( unsigned i = 0; i < nBatch; ++i )
+        ok = ok && check_transposed( s[0], s[1], &a[i * inStride], s[1], &b[i * outStride], s[0] );
+      check( ok, "transpose_batch with strides", s[0], s[1], inStride, outStride );
+    }
+
+    const unsigned rsIn = s[1] + 1, rsOut = s[0] + 2;
+    const std::size_t nIn = std::size_t(s[0]) * rsIn * nBatch, nOut = std::size_t(s[1]) * rsOut * nBatch;
+    std::vector<T> a( nIn ), b( nOut );
+    std::vector<const T *> pins( nBatch );
+    std::vector<T *> pouts( nBatch );
+    for ( unsigned i = 0; i < nBatch; ++i ) {
+      pins[i] = &a[std::size_t( nBatch - 1 - i ) * s[0] * rsIn];
+      pouts[i] = &b[std::size_t(i) * s[1] * rsOut];
+    }
+    check_fill( a.data(), a.size() );
+    transpose::transpose_batch<T>( transpose::mat_info { s[0], s[1], rsIn }, pins.data(),
+      transpose::mat_info { s[1], s[0], rsOut }, pouts.data(), nBatch );
+    bool ok = true;
+    for ( unsigned i = 0; i < nBatch; ++i )
+      ok = ok && check_transposed( s[0], s[1], pins[i], rsIn, pouts[i], rsOut );
+    check( ok, "transpose_batch with pointer arrays", s[0], s[1], rsIn, rsOut );
+  }
+}
+
+
+// permute() with row-major strides - the innermost rows padded by pad elements - against element-wise
+//   indexing: output axis k is input axis axes[k]
+template <class T>
+static bool check_permute_case(
+  const unsigned nDims, const std::size_t * shape, const unsigned * axes, const unsigned pad )
+{
+  std::size_t shapeOut[transpose::PERMUTE_MAX_DIMS], si[transpose::PERMUTE_MAX_DIMS], so[transpose::PERMUTE_MAX_DIMS];
+  for ( unsigned k = 0; k < nDims; ++k )
+    shapeOut[k] = shape[axes[k]];
+  si[nDims - 1] = so[nDims - 1] = 1;
+  for ( unsigned k = nDims - 1; k > 0; --k ) {
+    si[k - 1] = si[k] * shape[k] + ( k == nDims - 1 ? pad : 0 );
+    so[k - 1] = so[k] * shapeOut[k] + ( k == nDims - 1 ? pad : 0 );
+  }
+  const std::size_t nIn = si[0] * shape[0], nOut = so[0] * shapeOut[0];
+  std::vector<T> a( nIn ), b( nOut );
+  check_fill( a.data(), a.size() );
+  if ( !transpose::permute<T>( nDims, shape, si, axes, so, a.data(), b.data() ) )
+    return false;
+
+  std::size_t nElems = 1, idx[transpose::PERMUTE_MAX_DIMS] = { 0 };
+  for ( unsigned k = 0; k < nDims; ++k )
+    nElems *= shape[k];
+  for ( ; nElems; --nElems ) {
+    std::size_t i = 0, o = 0;
+    for ( unsigned k = 0; k < nDims; ++k ) {
+      i += idx[k] * si[k];
+      o += idx[axes[k]] * so[k];
+    }
+    if ( b[o] != a[i] )
+      return false;
+    for ( unsigned k = nDims; k--; ) {  // next index: the last axis runs fastest
+      if ( ++idx[k] < shape[k] )
+        break;
+      idx[k] = 0;
+    }
+  }
+  return true;
+}
+
+
+// permute(): the [B][R][C] -> [C][B][R] example of the README, an axis of size 1, axes which get fused,
+//   a core smaller than the kernel - transposed with transpose_batch() - and no transpose at the core.
+//   each unpadded and with padded rows. invalid axes and too many axes must get rejected
+template <class T>
+static void check_permute()
+{
+  struct perm_case { unsigned nDims; std::size_t shape[5]; unsigned axes[5]; };
+  static constexpr perm_case cases[] = {
+    { 3, { 5, 37, 29 }, { 2, 0, 1 } },
+    { 4, { 3, 1, 40, 33 }, { 0, 3, 1, 2 } },
+    { 4, { 4, 6, 20, 9 }, { 2, 3, 0, 1 } },
+    { 3, { 1000, 3, 2 }, { 0, 2, 1 } },
+    { 4, { 7, 300, 2, 3 }, { 1, 3, 0, 2 } },
+    { 3, { 6, 7, 5 }, { 1, 0, 2 } },
+    { 5, { 3, 4, 5, 6, 7 }, { 4, 2, 0, 3, 1 } },
+    { 1, { 17 }, { 0 } }
+  };
+  for ( const perm_case &c : cases ) {
+    for ( unsigned pad : { 0U, 3U } ) {
+      const bool ok = check_permute_case<T>( c.nDims, c.shape, c.axes, pad );
+      check( ok, "permute", c.nDims, c.shape[0], c.shape[1], c.axes[0], c.axes[1], pad );
+    }
+  }
+
+  const std::size_t shape[9] = { 2, 2, 2, 2, 2, 2, 2, 2, 2 }, strides[9] = { 256, 128, 64, 32, 16, 8, 4, 2, 1 };
+  const unsigned dup[3] = { 0, 0, 1 }, axes[9] = { 8, 7, 6, 5, 4, 3, 2, 1, 0 };
+  T a[512] = { }, b[512] = { };
+  check( !transpose::permute<T>( 3, shape, strides, dup, strides, a, b ), "permute rejecting duplicate axes" );
+  check( !transpose::permute<T>( 9, shape, strides, axes, strides, a, b ), "permute rejecting too many axes" );
+}
+
+
+// offset of channel c of pixel p in image n - in layout l
+static std::size_t check_layout_offset(
+  const transpose::tensor_layout l, const unsigned C, const std::size_t HW,
+  const unsigned n, const unsigned c, const std::size_t p )
+{
+  const unsigned B = transpose::LAYOUT_BLOCK;
+  if ( l == transpose::tensor_layout::NCHW )
+    return ( std::size_t(n) * C + c ) * HW + p;
+  if ( l == transpose::tensor_layout::NHWC )
+    return ( n * HW + p ) * C + c;
+  return n * ( ( C + B - 1 ) / B * B * HW ) + ( c / B * HW + p ) * B + c % B;
+}
+
+
+// reorder() between all pairs of NCHW, NHWC and NCHWc16 - and back: channel counts 3, 4 and 8 with the fixed size loops,
+//   16, 32 and 64 for the SIMD kernels and 17 with a padded last block. the padded channels must get zeroed
+template <class T>
+static void check_reorder()
+{
+  using transpose::tensor_layout;
+  static constexpr tensor_layout layouts[] = { tensor_layout::NCHW, tensor_layout::NHWC, tensor_layout::NCHWc16 };
+  static constexpr unsigned shapes[][2] = { { 5, 7 }, { 16, 20 } };
+  const unsigned N = 2;
+  for ( unsigned C : { 3U, 4U, 8U, 16U, 32U, 64U, 17U } ) {
+    const unsigned CP = ( C + transpose::LAYOUT_BLOCK - 1 ) / transpose::LAYOUT_BLOCK * transpose::LAYOUT_BLOCK;
+    for ( const auto &s : shapes ) {
+      const std::size_t HW = std::size_t(s[0]) * s[1];
+      const std::size_t nMax = N * transpose::nchwc16_image_size( C, s[0], s[1] );
+      for ( tensor_layout from : layouts ) {
+        for ( tensor_layout to : layouts ) {
+          if ( from == to )
+            continue;
+          // input with zeroed padding, outputs with non-zero garbage
+          std::vector<T> a( nMax, T() ), b( nMax, check_value<T>( 77 ) ), c( nMax, check_value<T>( 99 ) );
+          for ( unsigned n = 0; n < N; ++n )
+            for ( unsigned ch = 0; ch < C; ++ch )
+              for ( std::size_t p = 0; p < HW; ++p )
+                a[check_layout_offset( from, C, HW, n, ch, p )] = check_value<T>( ( std::size_t(n) * C + ch ) * HW + p );
+          const bool ret = transpose::reorder<T>( from, to, N, C, s[0], s[1], a.data(), b.data() )
+            && transpose::reorder<T>( to, from, N, C, s[0], s[1], b.data(), c.data() );
+          bool ok = ret, padding = true;
+          for ( unsigned n = 0; n < N; ++n ) {
+            for ( std::size_t p = 0; p < HW; ++p ) {
+              for ( unsigned ch = 0; ch < C; ++ch ) {
+                const std::size_t i = check_layout_offset( from, C, HW, n, ch, p );
+                ok = ok && b[check_layout_offset( to, C, HW, n, ch, p )] == a[i] && c[i] == a[i];
+              }
+              for ( unsigned ch = C; ch < CP; ++ch ) {
+                if ( to == tensor_layout::NCHWc16 )
+                  padding = padding && b[check_layout_offset( to, C, HW, n, ch, p )] == T();
+                if ( from == tensor_layout::NCHWc16 )
+                  padding = padding && c[check_layout_offset( from, C, HW, n, ch, p )] == T();
+              }
+            }
+          }
+          check( ok, "reorder", int(from), int(to), C, s[0], s[1] );
+          check( padding, "reorder zeroing the padded channels", int(from), int(to), C, s[0], s[1] );
+        }
+      }
+    }
+  }
+}
+
+
+// runs all checks for the element type T. returns the number of errors
+template <class T>
+static int run_checks()
+{
+  check_padding<T>();
+  check_parallel<T>();
+  check_parallel_co<T>();
+  check_numa<T>();
+  check_inplace<T>();
+  check_inplace_rect<T>();
+  check_batch<T>();
+  check_permute<T>();
+  check_reorder<T>();
+  return n_check_errors;
+}
@@ -0,0 +1,91 @@
+
+#pragma once
+
+#include "transpose_defs.hpp"
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#  define HAVE_AVX2_16X16X16_KERNEL 1
+#endif
+
+#ifdef HAVE_AVX2_16X16X16_KERNEL
+
+#include <cstdint>
+
+namespace transpose_kernels
+{
+
+template <class T, bool CONJUGATE_TPL = false>
+struct AVX2_16x16x16Kernel
+{
+  // requires AVX2
+  static constexpr unsigned KERNEL_SZ = 16;
+  static constexpr bool HAS_AA = true;
+  static constexpr bool CONJUGATE = CONJUGATE_TPL;
+  static_assert( !CONJUGATE_TPL, "CONJUGATE is not supported by AVX2_16x16x16Kernel" );
+  using BaseType = uint16_t;
+
+  // each output row is one 32 byte store
+  //   the ymm registers get loaded with columns 0 .. 7 (or 8 .. 15) of input row k in the low
+  //   and of row k+8 in the high lane. then, both lanes get transposed like in SSE2_8x8x16Kernel:
+  //   3 unpack stages of 8 instructions for 128 elements - the SSE2 kernel needs 24 for 64 elements
+
+  ALWAYS_INLINE static void transpose8x2(__m256i r[8]) {
+    __m256i t[8];
+    for ( unsigned k = 0; k < 8; k += 2 ) {
+      t[k]   = _mm256_unpacklo_epi16( r[k], r[k+1] );  // columns 0 .. 3 of rows k, k+1
+      t[k+1] = _mm256_unpackhi_epi16( r[k], r[k+1] );  // columns 4 .. 7
+    }
+    for ( unsigned k = 0; k < 8; k += 4 ) {
+      r[k]   = _mm256_unpacklo_epi32( t[k],   t[k+2] );  // columns 0, 1 of rows k .. k+3
+      r[k+1] = _mm256_unpackhi_epi32( t[k],   t[k+2] );  // columns 2, 3
+      r[k+2] = _mm256_unpacklo_epi32( t[k+1], t[k+3] );  // columns 4, 5
+      r[k+3] = _mm256_unpackhi_epi32( t[k+1], t[k+3] );  // columns 6, 7
+    }
+    for ( unsigned k = 0; k < 4; ++k ) {
+      t[2*k]   = _mm256_unpacklo_epi64( r[k], r[k+4] );  // column 2k   of rows 0 .. 7
+      t[2*k+1] = _mm256_unpackhi_epi64( r[k], r[k+4] );  // column 2k+1
+    }
+    for ( unsigned k = 0; k < 8; ++k )
+      r[k] = t[k];
+  }
+
+  ALWAYS_INLINE static void op_uu(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    for ( unsigned c = 0; c < 16; c += 8 ) {
+      __m256i r[8];
+      for ( unsigned k = 0; k < 8; ++k ) {
+        const __m128i lo = _mm_loadu_si128( reinterpret_cast<const __m128i *>(&A[k*rowSizeA + c]) );
+        const __m128i hi = _mm_loadu_si128( reinterpret_cast<const __m128i *>(&A[(k+8)*rowSizeA + c]) );
+        r[k] = _mm256_inserti128_si256( _mm256_castsi128_si256(lo), hi, 1 );
+      }
+      transpose8x2(r);
+      for ( unsigned k = 0; k < 8; ++k )
+        _mm256_storeu_si256( reinterpret_cast<__m256i *>(&B[(c+k)*rowSizeB]), r[k] );
+    }
+  }
+
+  ALWAYS_INLINE static void op_aa(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    for ( unsigned c = 0; c < 16; c += 8 ) {
+      __m256i r[8];
+      for ( unsigned k = 0; k < 8; ++k ) {
+        const __m128i lo = _mm_load_si128( reinterpret_cast<const __m128i *>(&A[k*rowSizeA + c]) );
+        const __m128i hi = _mm_load_si128( reinterpret_cast<const __m128i *>(&A[(k+8)*rowSizeA + c]) );
+        r[k] = _mm256_inserti128_si256( _mm256_castsi128_si256(lo), hi, 1 );
+      }
+      transpose8x2(r);
+      for ( unsigned k = 0; k < 8; ++k )
+        _mm256_store_si256( reinterpret_cast<__m256i *>(&B[(c+k)*rowSizeB]), r[k] );
+    }
+  }
+
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,91 @@
+
+#pragma once
+
+#include "transpose_defs.hpp"
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#  define HAVE_AVX2_16X16X8_KERNEL 1
+#endif
+
+#ifdef HAVE_AVX2_16X16X8_KERNEL
+
+#include <cstdint>
+
+namespace transpose_kernels
+{
+
+template <class T, bool CONJUGATE_TPL = false>
+struct AVX2_16x16x8Kernel
+{
+  // requires AVX2
+  static constexpr unsigned KERNEL_SZ = 16;
+  static constexpr bool HAS_AA = true;
+  static constexpr bool CONJUGATE = CONJUGATE_TPL;
+  static_assert( !CONJUGATE_TPL, "CONJUGATE is not supported by AVX2_16x16x8Kernel" );
+  using BaseType = uint8_t;
+
+  // 256 bytes per invocation - SSE41_8x8x8Kernel moves 64 bytes
+  //   each ymm register holds input row k in the low lane and row k+8 in the high lane:
+  //   3 unpack stages transpose both 8x16 halves at once; per register, each lane has 2 columns then.
+  //   vpermq joins the 8 bytes of a column from both lanes: low lane is output row 2j, high lane row 2j+1
+
+  ALWAYS_INLINE static void transpose16(__m256i r[8]) {
+    __m256i t[8];
+    for ( unsigned k = 0; k < 8; k += 2 ) {
+      t[k]   = _mm256_unpacklo_epi8( r[k], r[k+1] );  // columns 0 .. 7 of rows k, k+1
+      t[k+1] = _mm256_unpackhi_epi8( r[k], r[k+1] );  // columns 8 .. 15
+    }
+    for ( unsigned k = 0; k < 8; k += 4 ) {
+      r[k]   = _mm256_unpacklo_epi16( t[k],   t[k+2] );  // columns  0 ..  3 of rows k .. k+3
+      r[k+1] = _mm256_unpackhi_epi16( t[k],   t[k+2] );  // columns  4 ..  7
+      r[k+2] = _mm256_unpacklo_epi16( t[k+1], t[k+3] );  // columns  8 .. 11
+      r[k+3] = _mm256_unpackhi_epi16( t[k+1], t[k+3] );  // columns 12 .. 15
+    }
+    for ( unsigned k = 0; k < 4; ++k ) {
+      t[2*k]   = _mm256_unpacklo_epi32( r[k], r[k+4] );  // columns 4k,   4k+1 of rows 0 .. 7
+      t[2*k+1] = _mm256_unpackhi_epi32( r[k], r[k+4] );  // columns 4k+2, 4k+3
+    }
+    for ( unsigned k = 0; k < 8; ++k )
+      r[k] = _mm256_permute4x64_epi64( t[k], _MM_SHUFFLE(3,1,2,0) );
+  }
+
+  ALWAYS_INLINE static void op_uu(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    __m256i r[8];
+    for ( unsigned k = 0; k < 8; ++k ) {
+      const __m128i lo = _mm_loadu_si128( reinterpret_cast<const __m128i *>(&A[k*rowSizeA]) );
+      const __m128i hi = _mm_loadu_si128( reinterpret_cast<const __m128i *>(&A[(k+8)*rowSizeA]) );
+      r[k] = _mm256_inserti128_si256( _mm256_castsi128_si256(lo), hi, 1 );
+    }
+    transpose16(r);
+    for ( unsigned k = 0; k < 8; ++k ) {
+      _mm_storeu_si128( reinterpret_cast<__m128i *>(&B[(2*k)*rowSizeB]), _mm256_castsi256_si128(r[k]) );
+      _mm_storeu_si128( reinterpret_cast<__m128i *>(&B[(2*k+1)*rowSizeB]), _mm256_extracti128_si256(r[k], 1) );
+    }
+  }
+
+  ALWAYS_INLINE static void op_aa(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    __m256i r[8];
+    for ( unsigned k = 0; k < 8; ++k ) {
+      const __m128i lo = _mm_load_si128( reinterpret_cast<const __m128i *>(&A[k*rowSizeA]) );
+      const __m128i hi = _mm_load_si128( reinterpret_cast<const __m128i *>(&A[(k+8)*rowSizeA]) );
+      r[k] = _mm256_inserti128_si256( _mm256_castsi128_si256(lo), hi, 1 );
+    }
+    transpose16(r);
+    for ( unsigned k = 0; k < 8; ++k ) {
+      _mm_store_si128( reinterpret_cast<__m128i *>(&B[(2*k)*rowSizeB]), _mm256_castsi256_si128(r[k]) );
+      _mm_store_si128( reinterpret_cast<__m128i *>(&B[(2*k+1)*rowSizeB]), _mm256_extracti128_si256(r[k], 1) );
+    }
+  }
+
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,113 @@
+
+#pragma once
+
+#include "transpose_defs.hpp"
+
+#if defined(__AVX512F__)
+#  include <immintrin.h>
+#  define HAVE_AVX512_16X16X32_KERNEL 1
+#endif
+
+#ifdef HAVE_AVX512_16X16X32_KERNEL
+
+#include <cstdint>
+
+// gcc 12 falsely warns on _mm512_undefined_*() inside the intrinsics, see https://gcc.gnu.org/bugzilla/show_bug.cgi?id=105593
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace transpose_kernels
+{
+
+template <class T, bool CONJUGATE_TPL = false>
+struct AVX512_16x16x32Kernel
+{
+  // requires AVX-512F
+  static constexpr unsigned KERNEL_SZ = 16;
+  static constexpr bool HAS_AA = true;
+  static constexpr bool CONJUGATE = CONJUGATE_TPL;
+  static_assert( !CONJUGATE_TPL, "CONJUGATE is not supported by AVX512_16x16x32Kernel" );
+  using BaseType = float;
+
+  // 4 shuffle stages of 16 instructions for 256 elements: 1/4 shuffle per element
+  //   the AVX_8x8x32Kernel needs 3 stages of 8 instructions for 64 elements: 3/8 shuffle per element
+  // see https://stackoverflow.com/questions/29519222/how-to-transpose-a-16x16-matrix-using-simd-instructions
+
+  ALWAYS_INLINE static void transpose16(__m512 r[16]) {
+    __m512 t[16];
+    for ( unsigned k = 0; k < 16; k += 2 ) {
+      t[k]   = _mm512_unpacklo_ps( r[k], r[k+1] );
+      t[k+1] = _mm512_unpackhi_ps( r[k], r[k+1] );
+    }
+    for ( unsigned k = 0; k < 16; k += 4 ) {
+      r[k]   = _mm512_shuffle_ps( t[k],   t[k+2], _MM_SHUFFLE(1,0,1,0) );
+      r[k+1] = _mm512_shuffle_ps( t[k],   t[k+2], _MM_SHUFFLE(3,2,3,2) );
+      r[k+2] = _mm512_shuffle_ps( t[k+1], t[k+3], _MM_SHUFFLE(1,0,1,0) );
+      r[k+3] = _mm512_shuffle_ps( t[k+1], t[k+3], _MM_SHUFFLE(3,2,3,2) );
+    }
+    // 128-bit lanes
+    for ( unsigned k = 0; k < 4; ++k ) {
+      t[k]    = _mm512_shuffle_f32x4( r[k],   r[k+4],  0x88 );
+      t[k+4]  = _mm512_shuffle_f32x4( r[k],   r[k+4],  0xdd );
+      t[k+8]  = _mm512_shuffle_f32x4( r[k+8], r[k+12], 0x88 );
+      t[k+12] = _mm512_shuffle_f32x4( r[k+8], r[k+12], 0xdd );
+    }
+    for ( unsigned k = 0; k < 8; ++k ) {
+      r[k]   = _mm512_shuffle_f32x4( t[k], t[k+8], 0x88 );
+      r[k+8] = _mm512_shuffle_f32x4( t[k], t[k+8], 0xdd );
+    }
+  }
+
+  ALWAYS_INLINE static void op_uu(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    static_assert( sizeof(T) == sizeof(int32_t), "" );
+    __m512 r[16];
+    for ( unsigned k = 0; k < 16; ++k )
+      r[k] = _mm512_loadu_ps(&A[k*rowSizeA]);
+    transpose16(r);
+    for ( unsigned k = 0; k < 16; ++k )
+      _mm512_storeu_ps(&B[k*rowSizeB], r[k]);
+  }
+
+  ALWAYS_INLINE static void op_aa(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    static_assert( sizeof(T) == sizeof(int32_t), "" );
+    __m512 r[16];
+    for ( unsigned k = 0; k < 16; ++k )
+      r[k] = _mm512_load_ps(&A[k*rowSizeA]);
+    transpose16(r);
+    for ( unsigned k = 0; k < 16; ++k )
+      _mm512_store_ps(&B[k*rowSizeB], r[k]);
+  }
+
+  // streaming stores: see caware_kernel::nt_out()
+  ALWAYS_INLINE static void op_nt(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    static_assert( sizeof(T) == sizeof(int32_t), "" );
+    __m512 r[16];
+    for ( unsigned k = 0; k < 16; ++k )
+      r[k] = _mm512_load_ps(&A[k*rowSizeA]);
+    transpose16(r);
+    for ( unsigned k = 0; k < 16; ++k )
+      _mm512_stream_ps(&B[k*rowSizeB], r[k]);
+  }
+
+  ALWAYS_INLINE static void nt_fence() { _mm_sfence(); }
+
+};
+
+} // namespace
+
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic pop
+#endif
+
+#endif
@@ -0,0 +1,106 @@
+
+#pragma once
+
+#include "transpose_defs.hpp"
+#include <complex>
+#include <type_traits>
+
+#if defined(__AVX512F__)
+#  include <immintrin.h>
+#  define HAVE_AVX512_4X4X128_KERNEL 1
+#endif
+
+#ifdef HAVE_AVX512_4X4X128_KERNEL
+
+#include <cstdint>
+
+// gcc 12 falsely warns on _mm512_undefined_*() inside the intrinsics, see https://gcc.gnu.org/bugzilla/show_bug.cgi?id=105593
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace transpose_kernels
+{
+
+template <class T, bool CONJUGATE_TPL = false>
+struct AVX512_4x4x128Kernel
+{
+  // requires AVX-512F
+  static constexpr unsigned KERNEL_SZ = 4;
+  static constexpr bool HAS_AA = true;
+  static constexpr bool CONJUGATE = CONJUGATE_TPL;
+  using BaseType = std::complex<double>;
+
+  static_assert( !CONJUGATE
+    || std::is_same<T, std::complex<double> >::value
+    , "CONJUGATE is only supported by AVX512_4x4x128Kernel for std::complex<double>" );
+
+  // one row of 4 complex<double> is one 512-bit register: transpose 128-bit lanes with 2 stages of 4 shuffles
+
+  ALWAYS_INLINE static void transpose4(__m512d r[4]) {
+    const __m512d t0 = _mm512_shuffle_f64x2( r[0], r[1], 0x44 );  // a11 a12 a21 a22
+    const __m512d t1 = _mm512_shuffle_f64x2( r[0], r[1], 0xee );  // a13 a14 a23 a24
+    const __m512d t2 = _mm512_shuffle_f64x2( r[2], r[3], 0x44 );  // a31 a32 a41 a42
+    const __m512d t3 = _mm512_shuffle_f64x2( r[2], r[3], 0xee );  // a33 a34 a43 a44
+    r[0] = _mm512_shuffle_f64x2( t0, t2, 0x88 );  // a11 a21 a31 a41
+    r[1] = _mm512_shuffle_f64x2( t0, t2, 0xdd );  // a12 a22 a32 a42
+    r[2] = _mm512_shuffle_f64x2( t1, t3, 0x88 );
+    r[3] = _mm512_shuffle_f64x2( t1, t3, 0xdd );
+  }
+
+  ALWAYS_INLINE static __m512d conj(__m512d v) {
+    // negate imaginary parts: upper double of each complex<double>. xor_pd would require AVX-512DQ
+    static constexpr int64_t neg_bm = int64_t(0x8000000000000000ULL);
+    const __m512i cj = _mm512_set_epi64( neg_bm, 0, neg_bm, 0, neg_bm, 0, neg_bm, 0 );
+    return _mm512_castsi512_pd( _mm512_xor_si512( _mm512_castpd_si512(v), cj ) );
+  }
+
+  ALWAYS_INLINE static void op_uu(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const double * RESTRICT A = reinterpret_cast<const double * RESTRICT>(A_);
+    double * RESTRICT B = reinterpret_cast<double * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    __m512d r[4];
+    for ( unsigned k = 0; k < 4; ++k )
+      r[k] = _mm512_loadu_pd(&A[2*k*rowSizeA]);
+    transpose4(r);
+    for ( unsigned k = 0; k < 4; ++k )
+      _mm512_storeu_pd(&B[2*k*rowSizeB], CONJUGATE ? conj(r[k]) : r[k]);
+  }
+
+  ALWAYS_INLINE static void op_aa(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const double * RESTRICT A = reinterpret_cast<const double * RESTRICT>(A_);
+    double * RESTRICT B = reinterpret_cast<double * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    __m512d r[4];
+    for ( unsigned k = 0; k < 4; ++k )
+      r[k] = _mm512_load_pd(&A[2*k*rowSizeA]);
+    transpose4(r);
+    for ( unsigned k = 0; k < 4; ++k )
+      _mm512_store_pd(&B[2*k*rowSizeB], CONJUGATE ? conj(r[k]) : r[k]);
+  }
+
+  // streaming stores: see caware_kernel::nt_out()
+  ALWAYS_INLINE static void op_nt(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const double * RESTRICT A = reinterpret_cast<const double * RESTRICT>(A_);
+    double * RESTRICT B = reinterpret_cast<double * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    __m512d r[4];
+    for ( unsigned k = 0; k < 4; ++k )
+      r[k] = _mm512_load_pd(&A[2*k*rowSizeA]);
+    transpose4(r);
+    for ( unsigned k = 0; k < 4; ++k )
+      _mm512_stream_pd(&B[2*k*rowSizeB], CONJUGATE ? conj(r[k]) : r[k]);
+  }
+
+  ALWAYS_INLINE static void nt_fence() { _mm_sfence(); }
+
+};
+
+} // namespace
+
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic pop
+#endif
+
+#endif
@@ -0,0 +1,119 @@
+
+#pragma once
+
+#include "transpose_defs.hpp"
+#include <complex>
+#include <type_traits>
+
+#if defined(__AVX512F__)
+#  include <immintrin.h>
+#  define HAVE_AVX512_8X8X64_KERNEL 1
+#endif
+
+#ifdef HAVE_AVX512_8X8X64_KERNEL
+
+#include <cstdint>
+
+// gcc 12 falsely warns on _mm512_undefined_*() inside the intrinsics, see https://gcc.gnu.org/bugzilla/show_bug.cgi?id=105593
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace transpose_kernels
+{
+
+template <class T, bool CONJUGATE_TPL = false>
+struct AVX512_8x8x64Kernel
+{
+  // requires AVX-512F
+  static constexpr unsigned KERNEL_SZ = 8;
+  static constexpr bool HAS_AA = true;
+  static constexpr bool CONJUGATE = CONJUGATE_TPL;
+  using BaseType = double;
+
+  static_assert( !CONJUGATE
+    || std::is_same<T, std::complex<float> >::value
+    , "CONJUGATE is only supported by AVX512_8x8x64Kernel for std::complex<float>" );
+
+  // 3 shuffle stages of 8 instructions for 64 elements
+  //   unpack 64-bit pairs of 2 rows, then 128-bit lanes of 2 and 4 rows
+
+  ALWAYS_INLINE static void transpose8(__m512d r[8]) {
+    __m512d t[8];
+    for ( unsigned k = 0; k < 8; k += 2 ) {
+      t[k]   = _mm512_unpacklo_pd( r[k], r[k+1] );  // columns 0, 2, 4, 6 of rows k, k+1
+      t[k+1] = _mm512_unpackhi_pd( r[k], r[k+1] );  // columns 1, 3, 5, 7
+    }
+    for ( unsigned k = 0; k < 2; ++k ) {
+      r[k]   = _mm512_shuffle_f64x2( t[k],   t[k+2], 0x88 );  // columns 0, 4 of rows 0 .. 3
+      r[k+2] = _mm512_shuffle_f64x2( t[k],   t[k+2], 0xdd );  // columns 2, 6
+      r[k+4] = _mm512_shuffle_f64x2( t[k+4], t[k+6], 0x88 );  // columns 0, 4 of rows 4 .. 7
+      r[k+6] = _mm512_shuffle_f64x2( t[k+4], t[k+6], 0xdd );  // columns 2, 6
+    }
+    for ( unsigned k = 0; k < 4; ++k ) {
+      t[k]   = _mm512_shuffle_f64x2( r[k], r[k+4], 0x88 );
+      t[k+4] = _mm512_shuffle_f64x2( r[k], r[k+4], 0xdd );
+    }
+    // column order is 0, 1, 2, 3, 4, 5, 6, 7 now
+    for ( unsigned k = 0; k < 8; ++k )
+      r[k] = t[k];
+  }
+
+  ALWAYS_INLINE static __m512d conj(__m512d v) {
+    // negate imaginary parts: upper float of each 64-bit complex<float>. xor_pd would require AVX-512DQ
+    const __m512i cj = _mm512_set1_epi64( int64_t(0x8000000000000000ULL) );
+    return _mm512_castsi512_pd( _mm512_xor_si512( _mm512_castpd_si512(v), cj ) );
+  }
+
+  ALWAYS_INLINE static void op_uu(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    static_assert( sizeof(T) == sizeof(int64_t), "" );
+    __m512d r[8];
+    for ( unsigned k = 0; k < 8; ++k )
+      r[k] = _mm512_loadu_pd(&A[k*rowSizeA]);
+    transpose8(r);
+    for ( unsigned k = 0; k < 8; ++k )
+      _mm512_storeu_pd(&B[k*rowSizeB], CONJUGATE ? conj(r[k]) : r[k]);
+  }
+
+  ALWAYS_INLINE static void op_aa(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    static_assert( sizeof(T) == sizeof(int64_t), "" );
+    __m512d r[8];
+    for ( unsigned k = 0; k < 8; ++k )
+      r[k] = _mm512_load_pd(&A[k*rowSizeA]);
+    transpose8(r);
+    for ( unsigned k = 0; k < 8; ++k )
+      _mm512_store_pd(&B[k*rowSizeB], CONJUGATE ? conj(r[k]) : r[k]);
+  }
+
+  // streaming stores: see caware_kernel::nt_out()
+  ALWAYS_INLINE static void op_nt(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    static_assert( sizeof(T) == sizeof(int64_t), "" );
+    __m512d r[8];
+    for ( unsigned k = 0; k < 8; ++k )
+      r[k] = _mm512_load_pd(&A[k*rowSizeA]);
+    transpose8(r);
+    for ( unsigned k = 0; k < 8; ++k )
+      _mm512_stream_pd(&B[k*rowSizeB], CONJUGATE ? conj(r[k]) : r[k]);
+  }
+
+  ALWAYS_INLINE static void nt_fence() { _mm_sfence(); }
+
+};
+
+} // namespace
+
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic pop
+#endif
+
+#endif
@@ -40,7 +40,7 @@ struct AVX_4x4x128Kernel
 // could not find another way to have single initialization of variables - other than using C macros
 #define KERNEL_INIT() \
   static constexpr int64_t neg_bm = uint64_t(0x80000000) << 32; \
-  const __m256i cj = _mm256_set_epi64x(neg_bm, 0, neg_bm, 0); \
+  const __m256d cj = _mm256_castsi256_pd( _mm256_set_epi64x(neg_bm, 0, neg_bm, 0) ); \
   constexpr int imm_lo128 = 0x20; \
   constexpr int imm_hi128 = 0x31; \
   constexpr int C = sizeof(__m256d) / sizeof(T);
@@ -62,10 +62,10 @@ struct AVX_4x4x128Kernel
     __m256d a12a22 = _mm256_permute2f128_pd( a11a12, a21a22, imm_hi128 );                           \
     __m256d a32a42 = _mm256_permute2f128_pd( a31a32, a41a42, imm_hi128 );                           \
     if constexpr ( CONJUGATE ) {                                                                    \
-        a11a21 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a11a21 ), cj ) );      \
-        a31a41 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a31a41 ), cj ) );      \
-        a12a22 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a12a22 ), cj ) );      \
-        a32a42 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a32a42 ), cj ) );      \
+        a11a21 = _mm256_xor_pd( a11a21, cj );                                                       \
+        a31a41 = _mm256_xor_pd( a31a41, cj );                                                       \
+        a12a22 = _mm256_xor_pd( a12a22, cj );                                                       \
+        a32a42 = _mm256_xor_pd( a32a42, cj );                                                       \
     }                                                                                               \
 \
     __m256d a13a14 = _mm256_loadu_pd(reinterpret_cast<const double*>(&A[0*rowSizeA+C]));            \
@@ -83,10 +83,10 @@ struct AVX_4x4x128Kernel
     __m256d a14a24 = _mm256_permute2f128_pd( a13a14, a23a24, imm_hi128 );                           \
     __m256d a34a44 = _mm256_permute2f128_pd( a33a34, a43a44, imm_hi128 );                           \
     if constexpr ( CONJUGATE ) {                                                                    \
-        a13a23 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a13a23 ), cj ) );      \
-        a33a43 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a33a43 ), cj ) );      \
-        a14a24 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a14a24 ), cj ) );      \
-        a34a44 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a34a44 ), cj ) );      \
+        a13a23 = _mm256_xor_pd( a13a23, cj );                                                       \
+        a33a43 = _mm256_xor_pd( a33a43, cj );                                                       \
+        a14a24 = _mm256_xor_pd( a14a24, cj );                                                       \
+        a34a44 = _mm256_xor_pd( a34a44, cj );                                                       \
     }                                                                                               \
 \
     _mm256_storeu_pd(reinterpret_cast<double*>(&B[2*rowSizeB+0]), a13a23);                          \
@@ -111,10 +111,10 @@ struct AVX_4x4x128Kernel
     __m256d a12a22 = _mm256_permute2f128_pd( a11a12, a21a22, imm_hi128 );                           \
     __m256d a32a42 = _mm256_permute2f128_pd( a31a32, a41a42, imm_hi128 );                           \
     if constexpr ( CONJUGATE ) {                                                                    \
-        a11a21 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a11a21 ), cj ) );      \
-        a31a41 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a31a41 ), cj ) );      \
-        a12a22 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a12a22 ), cj ) );      \
-        a32a42 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a32a42 ), cj ) );      \
+        a11a21 = _mm256_xor_pd( a11a21, cj );                                                       \
+        a31a41 = _mm256_xor_pd( a31a41, cj );                                                       \
+        a12a22 = _mm256_xor_pd( a12a22, cj );                                                       \
+        a32a42 = _mm256_xor_pd( a32a42, cj );                                                       \
     }                                                                                               \
 \
     __m256d a13a14 = _mm256_load_pd(reinterpret_cast<const double*>(&A[0*rowSizeA+C]));             \
@@ -132,10 +132,10 @@ struct AVX_4x4x128Kernel
     __m256d a14a24 = _mm256_permute2f128_pd( a13a14, a23a24, imm_hi128 );                           \
     __m256d a34a44 = _mm256_permute2f128_pd( a33a34, a43a44, imm_hi128 );                           \
     if constexpr ( CONJUGATE ) {                                                                    \
-        a13a23 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a13a23 ), cj ) );      \
-        a33a43 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a33a43 ), cj ) );      \
-        a14a24 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a14a24 ), cj ) );      \
-        a34a44 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( a34a44 ), cj ) );      \
+        a13a23 = _mm256_xor_pd( a13a23, cj );                                                       \
+        a33a43 = _mm256_xor_pd( a33a43, cj );                                                       \
+        a14a24 = _mm256_xor_pd( a14a24, cj );                                                       \
+        a34a44 = _mm256_xor_pd( a34a44, cj );                                                       \
     }                                                                                               \
 \
     _mm256_store_pd(reinterpret_cast<double*>(&B[2*rowSizeB+0]), a13a23);                           \
@@ -40,7 +40,7 @@ struct AVX_4x4x64Kernel
 // could not find another way to have single initialization of variables - other than using C macros
 #define KERNEL_INIT() \
   static constexpr uint32_t neg_bm = 0x80000000; \
-  const __m256i cj = _mm256_set_epi32(neg_bm, 0, neg_bm, 0, neg_bm, 0, neg_bm, 0);
+  const __m256d cj = _mm256_castsi256_pd( _mm256_set_epi32(neg_bm, 0, neg_bm, 0, neg_bm, 0, neg_bm, 0) );
 
 // _MM_TRANSPOSE4_PD()
 // from https://github.com/romeric/Fastor/blob/master/Fastor/backend/transpose/transpose_kernels.h
@@ -63,16 +63,16 @@ struct AVX_4x4x64Kernel
     row0 = _mm256_permute2f128_pd(tmp0, tmp1, 0x20);                                                \
     row2 = _mm256_permute2f128_pd(tmp0, tmp1, 0x31);                                                \
     if constexpr ( CONJUGATE ) {                                                                    \
-        row0 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( row0 ), cj ) );          \
-        row2 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( row2 ), cj ) );          \
+        row0 = _mm256_xor_pd( row0, cj );                                                           \
+        row2 = _mm256_xor_pd( row2, cj );                                                           \
     }                                                                                               \
     _mm256_storeu_pd(&B[0*rowSizeB], row0);                                                         \
     _mm256_storeu_pd(&B[2*rowSizeB], row2);                                                         \
     row1 = _mm256_permute2f128_pd(tmp2, tmp3, 0x20);                                                \
     row3 = _mm256_permute2f128_pd(tmp2, tmp3, 0x31);                                                \
     if constexpr ( CONJUGATE ) {                                                                    \
-        row1 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( row1 ), cj ) );          \
-        row3 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( row3 ), cj ) );          \
+        row1 = _mm256_xor_pd( row1, cj );                                                           \
+        row3 = _mm256_xor_pd( row3, cj );                                                           \
     }                                                                                               \
     _mm256_storeu_pd(&B[1*rowSizeB], row1);                                                         \
     _mm256_storeu_pd(&B[3*rowSizeB], row3);                                                         \
@@ -95,16 +95,16 @@ struct AVX_4x4x64Kernel
     row0 = _mm256_permute2f128_pd(tmp0, tmp1, 0x20);                                                \
     row2 = _mm256_permute2f128_pd(tmp0, tmp1, 0x31);                                                \
     if constexpr ( CONJUGATE ) {                                                                    \
-        row0 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( row0 ), cj ) );          \
-        row2 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( row2 ), cj ) );          \
+        row0 = _mm256_xor_pd( row0, cj );                                                           \
+        row2 = _mm256_xor_pd( row2, cj );                                                           \
     }                                                                                               \
     _mm256_store_pd(&B[0*rowSizeB], row0);                                                          \
     _mm256_store_pd(&B[2*rowSizeB], row2);                                                          \
     row1 = _mm256_permute2f128_pd(tmp2, tmp3, 0x20);                                                \
     row3 = _mm256_permute2f128_pd(tmp2, tmp3, 0x31);                                                \
     if constexpr ( CONJUGATE ) {                                                                    \
-        row1 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( row1 ), cj ) );          \
-        row3 = _mm256_castsi256_pd( _mm256_xor_si256( _mm256_castpd_si256( row3 ), cj ) );          \
+        row1 = _mm256_xor_pd( row1, cj );                                                           \
+        row3 = _mm256_xor_pd( row3, cj );                                                           \
     }                                                                                               \
     _mm256_store_pd(&B[1*rowSizeB], row1);                                                          \
     _mm256_store_pd(&B[3*rowSizeB], row3);                                                          \
@@ -0,0 +1,83 @@
+
+#pragma once
+
+#include "transpose_defs.hpp"
+
+#if ( defined(__aarch64__) && defined(__ARM_NEON) ) || defined(_M_ARM64)
+#  include <arm_neon.h>
+#  define HAVE_NEON_16X16X8_KERNEL 1
+#endif
+
+#ifdef HAVE_NEON_16X16X8_KERNEL
+
+#include <cstdint>
+
+namespace transpose_kernels
+{
+
+template <class T, bool CONJUGATE_TPL = false>
+struct NEON_16x16x8Kernel
+{
+  // requires AArch64 NEON
+  static constexpr unsigned KERNEL_SZ = 16;
+  static constexpr bool HAS_AA = true;  // same operation: ld1/st1 have no alignment requirement
+  static constexpr bool CONJUGATE = CONJUGATE_TPL;
+  static_assert( !CONJUGATE_TPL, "CONJUGATE is not supported by NEON_16x16x8Kernel" );
+  using BaseType = uint8_t;
+
+  // native replacement of the sse2neon emulated SSE41_8x8x8Kernel:
+  //   4 stages of trn1/trn2 on 8, 16, 32 and 64 bit elements - each a single instruction.
+  //   after the stages, register k contains column k
+
+  ALWAYS_INLINE static void transpose16(uint8x16_t r[16]) {
+    for ( unsigned k = 0; k < 16; k += 2 ) {
+      const uint8x16_t a = vtrn1q_u8( r[k], r[k+1] );
+      const uint8x16_t b = vtrn2q_u8( r[k], r[k+1] );
+      r[k] = a;
+      r[k+1] = b;
+    }
+    for ( unsigned j = 0; j < 16; j += 4 ) {
+      for ( unsigned k = j; k < j + 2; ++k ) {
+        const uint16x8_t x = vreinterpretq_u16_u8( r[k] );
+        const uint16x8_t y = vreinterpretq_u16_u8( r[k+2] );
+        r[k]   = vreinterpretq_u8_u16( vtrn1q_u16( x, y ) );
+        r[k+2] = vreinterpretq_u8_u16( vtrn2q_u16( x, y ) );
+      }
+    }
+    for ( unsigned j = 0; j < 16; j += 8 ) {
+      for ( unsigned k = j; k < j + 4; ++k ) {
+        const uint32x4_t x = vreinterpretq_u32_u8( r[k] );
+        const uint32x4_t y = vreinterpretq_u32_u8( r[k+4] );
+        r[k]   = vreinterpretq_u8_u32( vtrn1q_u32( x, y ) );
+        r[k+4] = vreinterpretq_u8_u32( vtrn2q_u32( x, y ) );
+      }
+    }
+    for ( unsigned k = 0; k < 8; ++k ) {
+      const uint64x2_t x = vreinterpretq_u64_u8( r[k] );
+      const uint64x2_t y = vreinterpretq_u64_u8( r[k+8] );
+      r[k]   = vreinterpretq_u8_u64( vtrn1q_u64( x, y ) );
+      r[k+8] = vreinterpretq_u8_u64( vtrn2q_u64( x, y ) );
+    }
+  }
+
+  ALWAYS_INLINE static void op_uu(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    uint8x16_t r[16];
+    for ( unsigned k = 0; k < 16; ++k )
+      r[k] = vld1q_u8( &A[k*rowSizeA] );
+    transpose16(r);
+    for ( unsigned k = 0; k < 16; ++k )
+      vst1q_u8( &B[k*rowSizeB], r[k] );
+  }
+
+  ALWAYS_INLINE static void op_aa(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    op_uu( A_, B_, rowSizeA, rowSizeB );
+  }
+
+};
+
+} // namespace
+
+#endif
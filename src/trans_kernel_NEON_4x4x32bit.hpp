@@ -0,0 +1,57 @@
+
+#pragma once
+
+#include "transpose_defs.hpp"
+
+#if ( defined(__aarch64__) && defined(__ARM_NEON) ) || defined(_M_ARM64)
+#  include <arm_neon.h>
+#  define HAVE_NEON_4X4X32_KERNEL 1
+#endif
+
+#ifdef HAVE_NEON_4X4X32_KERNEL
+
+#include <cstdint>
+
+namespace transpose_kernels
+{
+
+template <class T, bool CONJUGATE_TPL = false>
+struct NEON_4x4x32Kernel
+{
+  // requires AArch64 NEON
+  static constexpr unsigned KERNEL_SZ = 4;
+  static constexpr bool HAS_AA = true;  // same operation: ld1/st1 have no alignment requirement
+  static constexpr bool CONJUGATE = CONJUGATE_TPL;
+  static_assert( !CONJUGATE_TPL, "CONJUGATE is not supported by NEON_4x4x32Kernel" );
+  using BaseType = uint32_t;
+
+  // 8 trn1/trn2 instructions - sse2neon's _MM_TRANSPOSE4_PS needs more
+
+  ALWAYS_INLINE static void op_uu(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    const uint32x4_t r0 = vld1q_u32( &A[0*rowSizeA] );
+    const uint32x4_t r1 = vld1q_u32( &A[1*rowSizeA] );
+    const uint32x4_t r2 = vld1q_u32( &A[2*rowSizeA] );
+    const uint32x4_t r3 = vld1q_u32( &A[3*rowSizeA] );
+    // columns 0, 2 and 1, 3 of rows 0, 1 and rows 2, 3
+    const uint64x2_t t0 = vreinterpretq_u64_u32( vtrn1q_u32( r0, r1 ) );
+    const uint64x2_t t1 = vreinterpretq_u64_u32( vtrn2q_u32( r0, r1 ) );
+    const uint64x2_t t2 = vreinterpretq_u64_u32( vtrn1q_u32( r2, r3 ) );
+    const uint64x2_t t3 = vreinterpretq_u64_u32( vtrn2q_u32( r2, r3 ) );
+    vst1q_u32( &B[0*rowSizeB], vreinterpretq_u32_u64( vtrn1q_u64( t0, t2 ) ) );
+    vst1q_u32( &B[1*rowSizeB], vreinterpretq_u32_u64( vtrn1q_u64( t1, t3 ) ) );
+    vst1q_u32( &B[2*rowSizeB], vreinterpretq_u32_u64( vtrn2q_u64( t0, t2 ) ) );
+    vst1q_u32( &B[3*rowSizeB], vreinterpretq_u32_u64( vtrn2q_u64( t1, t3 ) ) );
+  }
+
+  ALWAYS_INLINE static void op_aa(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    op_uu( A_, B_, rowSizeA, rowSizeB );
+  }
+
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,67 @@
+
+#pragma once
+
+#include "transpose_defs.hpp"
+
+#if ( defined(__aarch64__) && defined(__ARM_NEON) ) || defined(_M_ARM64)
+#  include <arm_neon.h>
+#  define HAVE_NEON_4X4X64_KERNEL 1
+#endif
+
+#ifdef HAVE_NEON_4X4X64_KERNEL
+
+#include <cstdint>
+#include <complex>
+#include <type_traits>
+
+namespace transpose_kernels
+{
+
+template <class T, bool CONJUGATE_TPL = false>
+struct NEON_4x4x64Kernel
+{
+  // requires AArch64 NEON
+  static constexpr unsigned KERNEL_SZ = 4;
+  static constexpr bool HAS_AA = true;  // same operation: ld1/st1 have no alignment requirement
+  static constexpr bool CONJUGATE = CONJUGATE_TPL;
+  static_assert( !CONJUGATE_TPL || std::is_same<T, std::complex<float> >::value,
+    "CONJUGATE is only supported by NEON_4x4x64Kernel for std::complex<float>" );
+  using BaseType = uint64_t;
+
+  // each row is 2 registers: 2x2 blocks of 2x2 elements, each transposed with trn1/trn2.
+  //   conjugation flips the sign bit of the imaginary part - in the upper 32 bits
+
+  ALWAYS_INLINE static void op_uu(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    uint64x2_t r[4][2];
+    for ( unsigned k = 0; k < 4; ++k ) {
+      r[k][0] = vld1q_u64( &A[k*rowSizeA] );
+      r[k][1] = vld1q_u64( &A[k*rowSizeA + 2] );
+    }
+    if ( CONJUGATE ) {
+      const uint64x2_t neg = vdupq_n_u64( UINT64_C(0x8000000000000000) );
+      for ( unsigned k = 0; k < 4; ++k ) {
+        r[k][0] = veorq_u64( r[k][0], neg );
+        r[k][1] = veorq_u64( r[k][1], neg );
+      }
+    }
+    // block of rows 2p, 2p+1 and columns 2h, 2h+1 => rows 2h, 2h+1 and columns 2p, 2p+1
+    for ( unsigned h = 0; h < 2; ++h ) {
+      for ( unsigned p = 0; p < 2; ++p ) {
+        vst1q_u64( &B[(2*h  )*rowSizeB + 2*p], vtrn1q_u64( r[2*p][h], r[2*p+1][h] ) );
+        vst1q_u64( &B[(2*h+1)*rowSizeB + 2*p], vtrn2q_u64( r[2*p][h], r[2*p+1][h] ) );
+      }
+    }
+  }
+
+  ALWAYS_INLINE static void op_aa(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    op_uu( A_, B_, rowSizeA, rowSizeB );
+  }
+
+};
+
+} // namespace
+
+#endif
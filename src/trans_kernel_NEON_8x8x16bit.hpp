@@ -0,0 +1,73 @@
+
+#pragma once
+
+#include "transpose_defs.hpp"
+
+#if ( defined(__aarch64__) && defined(__ARM_NEON) ) || defined(_M_ARM64)
+#  include <arm_neon.h>
+#  define HAVE_NEON_8X8X16_KERNEL 1
+#endif
+
+#ifdef HAVE_NEON_8X8X16_KERNEL
+
+#include <cstdint>
+
+namespace transpose_kernels
+{
+
+template <class T, bool CONJUGATE_TPL = false>
+struct NEON_8x8x16Kernel
+{
+  // requires AArch64 NEON
+  static constexpr unsigned KERNEL_SZ = 8;
+  static constexpr bool HAS_AA = true;  // same operation: ld1/st1 have no alignment requirement
+  static constexpr bool CONJUGATE = CONJUGATE_TPL;
+  static_assert( !CONJUGATE_TPL, "CONJUGATE is not supported by NEON_8x8x16Kernel" );
+  using BaseType = uint16_t;
+
+  // trn1/trn2 on 16, 32 and 64 bit elements: register k contains column k afterwards
+
+  ALWAYS_INLINE static void transpose8(uint16x8_t r[8]) {
+    for ( unsigned k = 0; k < 8; k += 2 ) {
+      const uint16x8_t a = vtrn1q_u16( r[k], r[k+1] );
+      const uint16x8_t b = vtrn2q_u16( r[k], r[k+1] );
+      r[k] = a;
+      r[k+1] = b;
+    }
+    for ( unsigned j = 0; j < 8; j += 4 ) {
+      for ( unsigned k = j; k < j + 2; ++k ) {
+        const uint32x4_t x = vreinterpretq_u32_u16( r[k] );
+        const uint32x4_t y = vreinterpretq_u32_u16( r[k+2] );
+        r[k]   = vreinterpretq_u16_u32( vtrn1q_u32( x, y ) );
+        r[k+2] = vreinterpretq_u16_u32( vtrn2q_u32( x, y ) );
+      }
+    }
+    for ( unsigned k = 0; k < 4; ++k ) {
+      const uint64x2_t x = vreinterpretq_u64_u16( r[k] );
+      const uint64x2_t y = vreinterpretq_u64_u16( r[k+4] );
+      r[k]   = vreinterpretq_u16_u64( vtrn1q_u64( x, y ) );
+      r[k+4] = vreinterpretq_u16_u64( vtrn2q_u64( x, y ) );
+    }
+  }
+
+  ALWAYS_INLINE static void op_uu(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    uint16x8_t r[8];
+    for ( unsigned k = 0; k < 8; ++k )
+      r[k] = vld1q_u16( &A[k*rowSizeA] );
+    transpose8(r);
+    for ( unsigned k = 0; k < 8; ++k )
+      vst1q_u16( &B[k*rowSizeB], r[k] );
+  }
+
+  ALWAYS_INLINE static void op_aa(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    op_uu( A_, B_, rowSizeA, rowSizeB );
+  }
+
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,84 @@
+
+#pragma once
+
+#include "transpose_defs.hpp"
+
+#if defined(__aarch64__) || defined(__arm__)
+#  include "sse2neon/sse2neon.h"
+#  define HAVE_SSE2_4X4X128_KERNEL 1
+#elif (defined(__SSE__) && defined(__SSE2__) ) || ( defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86) && _M_IX86 >= 2) )
+#  include <immintrin.h>
+#  define HAVE_SSE2_4X4X128_KERNEL 1
+#endif
+
+#ifdef HAVE_SSE2_4X4X128_KERNEL
+
+#include <cstdint>
+#include <complex>
+#include <type_traits>
+
+namespace transpose_kernels
+{
+
+template <class T, bool CONJUGATE_TPL = false>
+struct SSE2_4x4x128Kernel
+{
+  // requires SSE2
+  static constexpr unsigned KERNEL_SZ = 4;
+  static constexpr bool HAS_AA = true;
+  static constexpr bool CONJUGATE = CONJUGATE_TPL;
+  static_assert( !CONJUGATE_TPL || std::is_same<T, std::complex<double> >::value,
+    "CONJUGATE is only supported by SSE2_4x4x128Kernel for std::complex<double>" );
+  using BaseType = std::complex<double>;
+
+  // fallback for AVX_4x4x128Kernel, when AVX is not available:
+  //   one element per register - no shuffles, just a copy of the 16 elements.
+  //   conjugation flips the sign bit of the imaginary part - in the upper double
+
+  template <bool ALIGNED, bool STREAM = false>
+  ALWAYS_INLINE static void op(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    const __m128d neg = _mm_set_pd( -0.0, 0.0 );
+    for ( unsigned k = 0; k < 4; ++k ) {
+      __m128d r[4];
+      for ( unsigned c = 0; c < 4; ++c ) {
+        const double * p = reinterpret_cast<const double *>(&A[c*rowSizeA + k]);
+        r[c] = ALIGNED ? _mm_load_pd( p ) : _mm_loadu_pd( p );
+        if ( CONJUGATE )
+          r[c] = _mm_xor_pd( r[c], neg );
+      }
+      for ( unsigned c = 0; c < 4; ++c ) {
+        double * p = reinterpret_cast<double *>(&B[k*rowSizeB + c]);
+        if ( STREAM )
+          _mm_stream_pd( p, r[c] );
+        else if ( ALIGNED )
+          _mm_store_pd( p, r[c] );
+        else
+          _mm_storeu_pd( p, r[c] );
+      }
+    }
+    (void)neg;
+  }
+
+  ALWAYS_INLINE static void op_uu(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    op<false>( A_, B_, rowSizeA, rowSizeB );
+  }
+
+  ALWAYS_INLINE static void op_aa(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    op<true>( A_, B_, rowSizeA, rowSizeB );
+  }
+
+  // streaming stores: see caware_kernel::nt_out()
+  ALWAYS_INLINE static void op_nt(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    op<true, true>( A_, B_, rowSizeA, rowSizeB );
+  }
+
+  ALWAYS_INLINE static void nt_fence() { _mm_sfence(); }
+
+};
+
+} // namespace
+
+#endif
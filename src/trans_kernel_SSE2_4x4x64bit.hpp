@@ -0,0 +1,87 @@
+
+#pragma once
+
+#include "transpose_defs.hpp"
+
+#if defined(__aarch64__) || defined(__arm__)
+#  include "sse2neon/sse2neon.h"
+#  define HAVE_SSE2_4X4X64_KERNEL 1
+#elif (defined(__SSE__) && defined(__SSE2__) ) || ( defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86) && _M_IX86 >= 2) )
+#  include <immintrin.h>
+#  define HAVE_SSE2_4X4X64_KERNEL 1
+#endif
+
+#ifdef HAVE_SSE2_4X4X64_KERNEL
+
+#include <cstdint>
+#include <complex>
+#include <type_traits>
+
+namespace transpose_kernels
+{
+
+template <class T, bool CONJUGATE_TPL = false>
+struct SSE2_4x4x64Kernel
+{
+  // requires SSE2
+  static constexpr unsigned KERNEL_SZ = 4;
+  static constexpr bool HAS_AA = true;
+  static constexpr bool CONJUGATE = CONJUGATE_TPL;
+  static_assert( !CONJUGATE_TPL || std::is_same<T, std::complex<float> >::value,
+    "CONJUGATE is only supported by SSE2_4x4x64Kernel for std::complex<float>" );
+  using BaseType = uint64_t;
+
+  // fallback for AVX_4x4x64Kernel, when AVX is not available:
+  //   each row is 2 registers: 2x2 blocks of 2x2 elements, each transposed with unpacklo/hi_epi64.
+  //   conjugation flips the sign bit of the imaginary part - in the upper 32 bits
+
+  template <bool ALIGNED>
+  ALWAYS_INLINE static void op(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    const BaseType * RESTRICT A = reinterpret_cast<const BaseType * RESTRICT>(A_);
+    BaseType * RESTRICT B = reinterpret_cast<BaseType * RESTRICT>(B_);
+    static_assert( sizeof(T) == sizeof(BaseType), "" );
+    __m128i r[4][2];
+    for ( unsigned k = 0; k < 4; ++k ) {
+      for ( unsigned h = 0; h < 2; ++h ) {
+        const __m128i * p = reinterpret_cast<const __m128i *>(&A[k*rowSizeA + 2*h]);
+        r[k][h] = ALIGNED ? _mm_load_si128( p ) : _mm_loadu_si128( p );
+      }
+    }
+    if ( CONJUGATE ) {
+      const __m128i neg = _mm_set1_epi64x( int64_t( UINT64_C(0x8000000000000000) ) );
+      for ( unsigned k = 0; k < 4; ++k ) {
+        r[k][0] = _mm_xor_si128( r[k][0], neg );
+        r[k][1] = _mm_xor_si128( r[k][1], neg );
+      }
+    }
+    // block of rows 2p, 2p+1 and columns 2h, 2h+1 => rows 2h, 2h+1 and columns 2p, 2p+1
+    for ( unsigned h = 0; h < 2; ++h ) {
+      for ( unsigned p = 0; p < 2; ++p ) {
+        __m128i * lo = reinterpret_cast<__m128i *>(&B[(2*h  )*rowSizeB + 2*p]);
+        __m128i * hi = reinterpret_cast<__m128i *>(&B[(2*h+1)*rowSizeB + 2*p]);
+        const __m128i a = _mm_unpacklo_epi64( r[2*p][h], r[2*p+1][h] );
+        const __m128i b = _mm_unpackhi_epi64( r[2*p][h], r[2*p+1][h] );
+        if ( ALIGNED ) {
+          _mm_store_si128( lo, a );
+          _mm_store_si128( hi, b );
+        } else {
+          _mm_storeu_si128( lo, a );
+          _mm_storeu_si128( hi, b );
+        }
+      }
+    }
+  }
+
+  ALWAYS_INLINE static void op_uu(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    op<false>( A_, B_, rowSizeA, rowSizeB );
+  }
+
+  ALWAYS_INLINE static void op_aa(const T * RESTRICT A_, T * RESTRICT B_, const unsigned rowSizeA, const unsigned rowSizeB) {
+    op<true>( A_, B_, rowSizeA, rowSizeB );
+  }
+
+};
+
+} // namespace
+
+#endif
@@ -27,7 +27,7 @@ struct SSE41_8x8x8Kernel
   static_assert( !CONJUGATE_TPL, "CONJUGATE is not supported by SSE41_8x8x8Kernel" );
   using BaseType = uint8_t;
 
-  static constexpr bool HAS_AA = false;
+  static constexpr bool HAS_AA = true;  // same operation: 8 byte loads and stores have no alignment requirement
 };
 
 } // namespace
@@ -40,15 +40,6 @@ struct SSE41_8x8x8Kernel
   const __m128i shuffle8x8Mask   = _mm_setr_epi8(0, 1, 2, 3, 8, 9, 10, 11, 4,  5, 6, 7, 12,  13, 14, 15)
 
 
-#define KERNEL_OP_AA() do { \
-    (void)transpose4x4mask; \
-    (void)shuffle8x8Mask; \
-    (void)A_; \
-    (void)B_; \
-    (void)rowSizeA; \
-    (void)rowSizeB; \
-} while (0)
-
 // https://stackoverflow.com/questions/42162270/a-better-8x8-bytes-matrix-transpose-with-sse
 
 // void TransposeBlock8x8(uint8_t *src, uint8_t *dst, int srcStride, int dstStride) {
@@ -90,6 +81,8 @@ struct SSE41_8x8x8Kernel
     *((uint64_t*)(B + 7 * rowSizeB)) = _mm_extract_epi64(store3, 1);                                \
   } while (0)
 
+#define KERNEL_OP_AA()  KERNEL_OP_UU()
+
 #endif  // HAVE_SSE41_8x8x8_KERNEL
 
 #if 0
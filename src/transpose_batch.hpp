@@ -0,0 +1,157 @@
+#pragma once
+
+// batched transpose of many small matrices of the same shape:
+//   a plan - kernel, grid and tails - is built once for the whole batch, see transpose_plan.hpp.
+//   matrices with nRows or nCols below the kernel size would be transposed mostly element-wise in the tails:
+//   these get transposed across matrices - in chunks of matrices, which fit into the L1 cache:
+//   the chunk of G matrices, each a row of nRows * nCols elements, is transposed with the SIMD kernel
+//   into nRows * nCols rows of G elements, one row per matrix element. there, transposing each matrix
+//   is just a reordering of rows - before the SIMD kernel transposes back into the G output matrices.
+//   with contiguous matrices, several matrices form one row - to get rows of at least the kernel size
+
+#include "transpose_defs.hpp"
+#include "transpose_dispatch.hpp"
+#include "transpose_plan.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <complex>
+#include <type_traits>
+
+
+namespace transpose
+{
+
+// bytes of each chunk buffer in the transpose across matrices
+static constexpr unsigned BATCH_CHUNK_BYTES = 8192;
+
+
+// layout of the transpose across matrices: P matrices per row and chunks of G rows
+struct batch_across
+{
+  unsigned P;
+  unsigned G;
+};
+
+
+// P and G for the transpose across matrices of nRows x nCols elements of elemSize bytes
+//   returns G == 0, when the matrices are too large for it - or get transposed within the matrices.
+//   contiguous: the matrices follow each other without gaps, in input and output
+HEDLEY_CONST
+inline batch_across calc_batch_across(
+  const unsigned elemSize, const unsigned kernelSz, const unsigned nRows, const unsigned nCols,
+  const bool contiguous )
+{
+  const unsigned RC = nRows * nCols;
+  if ( !RC || ( nRows >= kernelSz && nCols >= kernelSz ) )
+    return batch_across { 1, 0 };
+  const unsigned P = ( contiguous && RC < kernelSz ) ? ( kernelSz + RC - 1 ) / RC : 1;
+  const unsigned rowBytes = P * RC * elemSize;
+  unsigned G = BATCH_CHUNK_BYTES / rowBytes;
+  if ( G < kernelSz )
+    return batch_across { 1, 0 };
+  return batch_across { P, G - G % kernelSz };
+}
+
+
+// transpose across matrices of a chunk of G rows, each with P contiguous nRows x nCols matrices,
+//   with row size inRowSize into G rows, each with P nCols x nRows matrices, with row size outRowSize.
+//   a and b are scratch buffers of BATCH_CHUNK_BYTES - the chunk gets transposed in the L1 cache
+template <class T, bool CONJUGATE>
+HEDLEY_NO_THROW
+static void batch_across_chunk(
+  const unsigned nRows, const unsigned nCols, const unsigned P, const unsigned G,
+  const T * RESTRICT pin, const std::size_t inRowSize,
+  T * RESTRICT pout, const std::size_t outRowSize,
+  T * RESTRICT a, T * RESTRICT b )
+{
+  const unsigned RC = nRows * nCols, W = P * RC;
+  // one row of G elements per element of the P matrices
+  transpose<T, CONJUGATE>( mat_info { G, W, unsigned(inRowSize) }, pin, mat_info { W, G, G }, a );
+  for ( unsigned p = 0; p < P; ++p )
+    for ( unsigned r = 0; r < nRows; ++r )
+      for ( unsigned c = 0; c < nCols; ++c )
+        std::memcpy( &b[std::size_t( p * RC + c * nRows + r ) * G], &a[std::size_t( p * RC + r * nCols + c ) * G], G * sizeof(T) );
+  transpose<T, false>( mat_info { W, G, G }, b, mat_info { G, W, unsigned(outRowSize) }, pout );
+}
+
+
+// transposes nBatch matrices with the shapes in and out: matrix i from &pin[i * inStride] into &pout[i * outStride]
+//   strides are in elements. CONJUGATE is only supported for std::complex<float or double>
+template <class T, bool CONJUGATE = false>
+HEDLEY_NO_THROW
+static void transpose_batch(
+  const mat_info &in, NO_ESCAPE const T * RESTRICT pin, const std::size_t inStride,
+  const mat_info &out, NO_ESCAPE T * RESTRICT pout, const std::size_t outStride,
+  const unsigned nBatch )
+{
+  static const dispatch_entry * const e = std::is_trivially_copyable<T>::value
+    ? dispatch_select( sizeof(T), CONJUGATE ) : nullptr;
+  const unsigned RC = in.nRows * in.nCols;
+  unsigned i = 0;
+  if ( e && in.rowSize == in.nCols && out.rowSize == out.nCols ) {
+    const bool contiguous = ( inStride == RC && outStride == RC );
+    const batch_across ba = calc_batch_across( sizeof(T), e->kernel_sz, in.nRows, in.nCols, contiguous );
+    // the row sizes P * stride of the chunks are unsigned in mat_info: larger strides get the plan
+    if ( ba.G && std::size_t(ba.P) * inStride <= 0xFFFFFFFFU && std::size_t(ba.P) * outStride <= 0xFFFFFFFFU ) {
+      alignas(64) unsigned char raw[ 2 * BATCH_CHUNK_BYTES ];
+      T * a = reinterpret_cast<T *>( raw );
+      T * b = reinterpret_cast<T *>( raw + BATCH_CHUNK_BYTES );
+      // chunks of G rows - the last one shorter. less than P remaining matrices get the plan
+      for ( unsigned nLeft = nBatch / ba.P; nLeft; ) {
+        const unsigned G = ( nLeft < ba.G ) ? nLeft : ba.G;
+        batch_across_chunk<T, CONJUGATE>( in.nRows, in.nCols, ba.P, G,
+          &pin[i * inStride], ba.P * inStride, &pout[i * outStride], ba.P * outStride, a, b );
+        nLeft -= G;
+        i += ba.P * G;
+      }
+    }
+  }
+  const plan<T, CONJUGATE> pl( in, out );
+  for ( ; i < nBatch; ++i )
+    pl.execute( &pin[i * inStride], &pout[i * outStride] );
+}
+
+
+// transposes nBatch matrices with the shapes in and out: matrix i from pins[i] into pouts[i]
+//   for the transpose across matrices, chunks of matrices get copied into contiguous buffers - and back.
+//   CONJUGATE is only supported for std::complex<float or double>
+template <class T, bool CONJUGATE = false>
+HEDLEY_NO_THROW
+static void transpose_batch(
+  const mat_info &in, NO_ESCAPE const T * const * pins,
+  const mat_info &out, NO_ESCAPE T * const * pouts,
+  const unsigned nBatch )
+{
+  static const dispatch_entry * const e = std::is_trivially_copyable<T>::value
+    ? dispatch_select( sizeof(T), CONJUGATE ) : nullptr;
+  const unsigned R = in.nRows, C = in.nCols;
+  unsigned i = 0;
+  const batch_across ba = e ? calc_batch_across( sizeof(T), e->kernel_sz, R, C, false ) : batch_across { 1, 0 };
+  if ( ba.G ) {
+    alignas(64) unsigned char raw[ 4 * BATCH_CHUNK_BYTES ];
+    T * a = reinterpret_cast<T *>( raw );
+    T * b = reinterpret_cast<T *>( raw + BATCH_CHUNK_BYTES );
+    T * si = reinterpret_cast<T *>( raw + 2 * BATCH_CHUNK_BYTES );
+    T * so = reinterpret_cast<T *>( raw + 3 * BATCH_CHUNK_BYTES );
+    const std::size_t RC = std::size_t(R) * C;
+    while ( i < nBatch ) {
+      const unsigned G = ( nBatch - i < ba.G ) ? nBatch - i : ba.G;
+      for ( unsigned g = 0; g < G; ++g )
+        for ( unsigned r = 0; r < R; ++r )
+          std::memcpy( &si[g * RC + r * C], &pins[i + g][std::size_t(r) * in.rowSize], C * sizeof(T) );
+      batch_across_chunk<T, CONJUGATE>( R, C, 1, G, si, RC, so, RC, a, b );
+      for ( unsigned g = 0; g < G; ++g )
+        for ( unsigned c = 0; c < C; ++c )
+          std::memcpy( &pouts[i + g][std::size_t(c) * out.rowSize], &so[g * RC + c * R], R * sizeof(T) );
+      i += G;
+    }
+    return;
+  }
+  const plan<T, CONJUGATE> pl( in, out );
+  for ( ; i < nBatch; ++i )
+    pl.execute( pins[i], pouts[i] );
+}
+
+}
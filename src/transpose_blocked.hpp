@@ -0,0 +1,110 @@
+#pragma once
+
+// multi-level blocking around the SIMD kernels:
+//   the grid of full kernels gets traversed in L1 sized blocks of tiles,
+//   which are grouped into L2 and TLB sized super-blocks.
+//   caware_kernel::tiles_out() / tiles_in() alone walk through the full strided dimension per row of tiles:
+//   for large matrices, the touched lines of the strided side don't stay in L1 / L2 until their reuse
+//   by the next row of tiles - and each strided row is on it's own page.
+//   works with any tiles function, e.g. caware_kernel::tiles_out<ALIGNED>() or a raw_tiles_fn
+
+#include "transpose_defs.hpp"
+
+#include <cstddef>
+
+
+namespace transpose
+{
+
+// side lengths in kernel tiles of the square blocks: l1 x l1 tiles inside of l2 x l2 tiles.
+//   l2 is a multiple of l1
+struct block_sizes
+{
+  unsigned l1;
+  unsigned l2;
+};
+
+
+// block sizes for the element size and kernel size, from cache and TLB sizes - see detected_cpu_caches()
+//   in- and output block together should use half of the cache - leaving space for the other ways' lines.
+//   each of the l2 * kernelSz rows of the in- and output super-block might be on it's own page
+HEDLEY_CONST
+inline block_sizes calc_block_sizes(
+  const unsigned elemSize, const unsigned kernelSz,
+  const unsigned l1Bytes, const unsigned l2Bytes, const unsigned tlbEntries )
+{
+  const unsigned tileBytes = kernelSz * kernelSz * elemSize;
+  auto side = [tileBytes] ( unsigned cacheBytes ) -> unsigned {
+    const unsigned nTiles = cacheBytes / ( 4 * tileBytes );
+    unsigned n = 1;
+    while ( (n + 1) * (n + 1) <= nTiles )
+      ++n;
+    return n;
+  };
+  block_sizes b;
+  b.l1 = side( l1Bytes );
+  b.l2 = side( l2Bytes );
+  const unsigned tlb_tiles = tlbEntries / ( 2 * kernelSz );
+  if ( b.l2 > tlb_tiles )
+    b.l2 = tlb_tiles;
+  b.l2 = ( b.l2 > b.l1 ) ? b.l1 * ( b.l2 / b.l1 ) : b.l1;
+  return b;
+}
+
+
+// blocked traversal of the output: the grid of nTileRows x nTileCols full kernels of the output matrix,
+//   with TILES_FN tiles( pin, pout, nTileRows, nTileCols, rowSizeA, rowSizeB ), iterating in output order
+template <class T, class TILES_FN>
+HEDLEY_NO_THROW
+static void blocked_tiles_out(
+  TILES_FN tiles,
+  NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout,
+  const unsigned nTileRows, const unsigned nTileCols, const unsigned kernelSz,
+  const unsigned rowSizeA, const unsigned rowSizeB, const block_sizes &bs )
+{
+  for ( unsigned R2 = 0; R2 < nTileRows; R2 += bs.l2 ) {
+    const unsigned R2e = ( nTileRows - R2 < bs.l2 ) ? nTileRows : R2 + bs.l2;
+    for ( unsigned C2 = 0; C2 < nTileCols; C2 += bs.l2 ) {
+      const unsigned C2e = ( nTileCols - C2 < bs.l2 ) ? nTileCols : C2 + bs.l2;
+      for ( unsigned R1 = R2; R1 < R2e; R1 += bs.l1 ) {
+        const unsigned nR = ( R2e - R1 < bs.l1 ) ? R2e - R1 : bs.l1;
+        for ( unsigned C1 = C2; C1 < C2e; C1 += bs.l1 ) {
+          const unsigned nC = ( C2e - C1 < bs.l1 ) ? C2e - C1 : bs.l1;
+          // output tile (R1, C1) is the transposed input tile (C1, R1)
+          tiles( &pin[ std::size_t(C1 * kernelSz) * rowSizeA + R1 * kernelSz ],
+            &pout[ std::size_t(R1 * kernelSz) * rowSizeB + C1 * kernelSz ],
+            nR, nC, rowSizeA, rowSizeB );
+        }
+      }
+    }
+  }
+}
+
+// blocked traversal of the input: the grid of nTileRows x nTileCols full kernels of the input matrix
+template <class T, class TILES_FN>
+HEDLEY_NO_THROW
+static void blocked_tiles_in(
+  TILES_FN tiles,
+  NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout,
+  const unsigned nTileRows, const unsigned nTileCols, const unsigned kernelSz,
+  const unsigned rowSizeA, const unsigned rowSizeB, const block_sizes &bs )
+{
+  for ( unsigned R2 = 0; R2 < nTileRows; R2 += bs.l2 ) {
+    const unsigned R2e = ( nTileRows - R2 < bs.l2 ) ? nTileRows : R2 + bs.l2;
+    for ( unsigned C2 = 0; C2 < nTileCols; C2 += bs.l2 ) {
+      const unsigned C2e = ( nTileCols - C2 < bs.l2 ) ? nTileCols : C2 + bs.l2;
+      for ( unsigned R1 = R2; R1 < R2e; R1 += bs.l1 ) {
+        const unsigned nR = ( R2e - R1 < bs.l1 ) ? R2e - R1 : bs.l1;
+        for ( unsigned C1 = C2; C1 < C2e; C1 += bs.l1 ) {
+          const unsigned nC = ( C2e - C1 < bs.l1 ) ? C2e - C1 : bs.l1;
+          // input tile (R1, C1) is the transposed output tile (C1, R1)
+          tiles( &pin[ std::size_t(R1 * kernelSz) * rowSizeA + C1 * kernelSz ],
+            &pout[ std::size_t(C1 * kernelSz) * rowSizeB + R1 * kernelSz ],
+            nR, nC, rowSizeA, rowSizeB );
+        }
+      }
+    }
+  }
+}
+
+}
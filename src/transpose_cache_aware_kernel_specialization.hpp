@@ -15,95 +15,89 @@ struct caware_kernel<T, CONJUGATE_TPL, transpose_kernels::KERNEL_NAME<T, CONJUGA
   using KERNEL = transpose_kernels::KERNEL_NAME<T, CONJUGATE_TPL>;
   using BaseType = typename KERNEL::BaseType;
   static constexpr bool HAS_AA = KERNEL::HAS_AA;
+  static constexpr bool HAS_NT = false;
   static constexpr unsigned KERNEL_SZ = KERNEL::KERNEL_SZ;
   static constexpr bool CONJUGATE = KERNEL::CONJUGATE;
   static_assert( CONJUGATE_TPL == CONJUGATE, "mismatching template parameters of caware_kernel and it's kernel" );
 
+  // uu_*_pf() / aa_*_pf(): the loops of uu_*() / aa_*() with prefetching pfDist tiles ahead, if PREFETCH
+  template <bool PREFETCH, bool NTA>
   HEDLEY_NO_THROW
-  static void uu_out(
+  static void uu_out_pf(
     const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
-    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout, const unsigned pfDist )
   {
     // iterate linearly through output matrix indices
     const unsigned N = out.nRows, M = out.nCols;
     const unsigned rowSizeB = out.rowSize, rowSizeA = in.rowSize;
     const unsigned out_inc = KERNEL_SZ * out.rowSize, in_inc = KERNEL_SZ * in.rowSize;
+    const unsigned pf_cols = pfDist * KERNEL_SZ, pf_off = pfDist * in_inc;
     unsigned out_row_off, in_row_off, row, col;
 
     KERNEL_INIT();
     for( row = out_row_off = 0; row + KERNEL_SZ <= N; row += KERNEL_SZ, out_row_off += out_inc ) {
       for( col = in_row_off = 0; col + KERNEL_SZ <= M; col += KERNEL_SZ, in_row_off += in_inc ) {
+        if constexpr ( PREFETCH ) {
+          if ( col + pf_cols + KERNEL_SZ <= M )
+            prefetch_tile<KERNEL_SZ, false, NTA>( &pin[in_row_off+pf_off+row], rowSizeA );
+        }
         const T * RESTRICT A_ = &pin[in_row_off+row];
         T * RESTRICT B_ = &pout[out_row_off+col];
         KERNEL_OP_UU();
       }
-      if ( col < M )  // tail columns with KERNEL_SZ rows
-        tail_transpose_out<T, T, CONJUGATE>( &pin[in_row_off+row], &pout[out_row_off+col], KERNEL_SZ, M - col, rowSizeA, rowSizeB );
-    }
-    if ( row < N ) {  // tail rows: #rows < KERNEL_SZ, #cols == KERNEL_SZ
-      for( col = in_row_off = 0; col + KERNEL_SZ <= M; col += KERNEL_SZ, in_row_off += in_inc )
-        tail_transpose_out<T, T, CONJUGATE>( &pin[in_row_off+row], &pout[out_row_off+col], N - row, KERNEL_SZ, rowSizeA, rowSizeB );
-      if ( col < M )  // tail columns - #rows < KERNEL_SZ, #cols < KERNEL_SZ
-        tail_transpose_out<T, T, CONJUGATE>( &pin[in_row_off+row], &pout[out_row_off+col], N - row, M - col, rowSizeA, rowSizeB );
     }
+    tails_out( in, pin, out, pout );
   }
 
+  template <bool PREFETCH, bool NTA>
   HEDLEY_NO_THROW
-  static void uu_in(
+  static void uu_in_pf(
     const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
-    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout, const unsigned pfDist )
   {
     // iterate linearly through input matrix indices
     const unsigned N = in.nRows, M = in.nCols;
     const unsigned rowSizeB = out.rowSize, rowSizeA = in.rowSize;
     const unsigned out_inc = KERNEL_SZ * rowSizeB, in_inc = KERNEL_SZ * rowSizeA;
+    const unsigned pf_cols = pfDist * KERNEL_SZ, pf_off = pfDist * out_inc;
     unsigned out_row_off, in_row_off, row, col;
 
     KERNEL_INIT();
     for( row = in_row_off = 0; row + KERNEL_SZ <= N; row += KERNEL_SZ, in_row_off += in_inc ) {
       for( col = out_row_off = 0; col + KERNEL_SZ <= M; col += KERNEL_SZ, out_row_off += out_inc ) {
+        if constexpr ( PREFETCH ) {
+          if ( col + pf_cols + KERNEL_SZ <= M )
+            prefetch_tile<KERNEL_SZ, true, NTA>( &pout[out_row_off+pf_off+row], rowSizeB );
+        }
         const T * RESTRICT A_ = &pin[in_row_off+col];
         T * RESTRICT B_ = &pout[out_row_off+row];
         KERNEL_OP_UU();
       }
-      if ( col < M )  // tail columns with KERNEL_SZ rows
-        tail_transpose_in<T, T, CONJUGATE>( &pin[in_row_off+col], &pout[out_row_off+row], KERNEL_SZ, M - col, rowSizeA, rowSizeB );
-    }
-    if ( row < N ) {  // tail rows: #rows < KERNEL_SZ, #cols == KERNEL_SZ
-      for( col = out_row_off = 0; col + KERNEL_SZ <= M; col += KERNEL_SZ, out_row_off += out_inc )
-        tail_transpose_in<T, T, CONJUGATE>( &pin[in_row_off+col], &pout[out_row_off+row], N - row, KERNEL_SZ, rowSizeA, rowSizeB );
-      if ( col < M )  // tail columns - #rows < KERNEL_SZ, #cols < KERNEL_SZ
-        tail_transpose_in<T, T, CONJUGATE>( &pin[in_row_off+col], &pout[out_row_off+row], N - row, M - col, rowSizeA, rowSizeB );
     }
+    tails_in( in, pin, out, pout );
   }
 
+  template <bool PREFETCH, bool NTA>
   HEDLEY_NO_THROW
-  static void uu_meta(
-    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
-    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
-  {
-    if ( in.nRows < in.nCols )
-      uu_in( in, pin, out, pout );
-    else
-      uu_out( in, pin, out, pout );
-  }
-
-
-  HEDLEY_NO_THROW
-  static void aa_out(
+  static void aa_out_pf(
     const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
-    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout, const unsigned pfDist )
   {
     // iterate linearly through output matrix indices
     const unsigned Nup = KERNEL_SZ * ( (out.nRows + KERNEL_SZ - 1) / KERNEL_SZ);
     const unsigned Mup = KERNEL_SZ * ( (out.nCols + KERNEL_SZ - 1) / KERNEL_SZ);
     const unsigned rowSizeB = out.rowSize, rowSizeA = in.rowSize;
     const unsigned out_inc = KERNEL_SZ * out.rowSize, in_inc = KERNEL_SZ * in.rowSize;
+    const unsigned pf_cols = pfDist * KERNEL_SZ, pf_off = pfDist * in_inc;
     unsigned out_row_off, in_row_off, row, col;
 
     KERNEL_INIT();
     for( row = out_row_off = 0; row + KERNEL_SZ <= Nup; row += KERNEL_SZ, out_row_off += out_inc ) {
       for( col = in_row_off = 0; col + KERNEL_SZ <= Mup; col += KERNEL_SZ, in_row_off += in_inc ) {
+        if constexpr ( PREFETCH ) {
+          if ( col + pf_cols + KERNEL_SZ <= Mup )
+            prefetch_tile<KERNEL_SZ, false, NTA>( &pin[in_row_off+pf_off+row], rowSizeA );
+        }
         const T * RESTRICT A_ = &pin[in_row_off+row];
         T * RESTRICT B_ = &pout[out_row_off+col];
         KERNEL_OP_AA();
@@ -111,21 +105,27 @@ struct caware_kernel<T, CONJUGATE_TPL, transpose_kernels::KERNEL_NAME<T, CONJUGA
     }
   }
 
+  template <bool PREFETCH, bool NTA>
   HEDLEY_NO_THROW
-  static void aa_in(
+  static void aa_in_pf(
     const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
-    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout, const unsigned pfDist )
   {
     // iterate linearly through input matrix indices
     const unsigned Nup = KERNEL_SZ * ( (in.nRows + KERNEL_SZ - 1) / KERNEL_SZ);
     const unsigned Mup = KERNEL_SZ * ( (in.nCols + KERNEL_SZ - 1) / KERNEL_SZ);
     const unsigned rowSizeB = out.rowSize, rowSizeA = in.rowSize;
     const unsigned out_inc = KERNEL_SZ * rowSizeB, in_inc = KERNEL_SZ * rowSizeA;
+    const unsigned pf_cols = pfDist * KERNEL_SZ, pf_off = pfDist * out_inc;
     unsigned out_row_off, in_row_off, row, col;
 
     KERNEL_INIT();
     for( row = in_row_off = 0; row + KERNEL_SZ <= Nup; row += KERNEL_SZ, in_row_off += in_inc ) {
       for( col = out_row_off = 0; col + KERNEL_SZ <= Mup; col += KERNEL_SZ, out_row_off += out_inc ) {
+        if constexpr ( PREFETCH ) {
+          if ( col + pf_cols + KERNEL_SZ <= Mup )
+            prefetch_tile<KERNEL_SZ, true, NTA>( &pout[out_row_off+pf_off+row], rowSizeB );
+        }
         const T * RESTRICT A_ = &pin[in_row_off+col];
         T * RESTRICT B_ = &pout[out_row_off+row];
         KERNEL_OP_AA();
@@ -133,6 +133,74 @@ struct caware_kernel<T, CONJUGATE_TPL, transpose_kernels::KERNEL_NAME<T, CONJUGA
     }
   }
 
+  HEDLEY_NO_THROW
+  static void uu_out(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+  {
+    const prefetch_mode pf = prefetch_setting().load( std::memory_order_relaxed );
+    if ( !pf.distance )
+      uu_out_pf<false, false>( in, pin, out, pout, 0 );
+    else if ( pf.nta )
+      uu_out_pf<true, true>( in, pin, out, pout, pf.distance );
+    else
+      uu_out_pf<true, false>( in, pin, out, pout, pf.distance );
+  }
+
+  HEDLEY_NO_THROW
+  static void uu_in(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+  {
+    const prefetch_mode pf = prefetch_setting().load( std::memory_order_relaxed );
+    if ( !pf.distance )
+      uu_in_pf<false, false>( in, pin, out, pout, 0 );
+    else if ( pf.nta )
+      uu_in_pf<true, true>( in, pin, out, pout, pf.distance );
+    else
+      uu_in_pf<true, false>( in, pin, out, pout, pf.distance );
+  }
+
+  HEDLEY_NO_THROW
+  static void uu_meta(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+  {
+    if ( in.nRows < in.nCols )
+      uu_in( in, pin, out, pout );
+    else
+      uu_out( in, pin, out, pout );
+  }
+
+
+  HEDLEY_NO_THROW
+  static void aa_out(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+  {
+    const prefetch_mode pf = prefetch_setting().load( std::memory_order_relaxed );
+    if ( !pf.distance )
+      aa_out_pf<false, false>( in, pin, out, pout, 0 );
+    else if ( pf.nta )
+      aa_out_pf<true, true>( in, pin, out, pout, pf.distance );
+    else
+      aa_out_pf<true, false>( in, pin, out, pout, pf.distance );
+  }
+
+  HEDLEY_NO_THROW
+  static void aa_in(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+  {
+    const prefetch_mode pf = prefetch_setting().load( std::memory_order_relaxed );
+    if ( !pf.distance )
+      aa_in_pf<false, false>( in, pin, out, pout, 0 );
+    else if ( pf.nta )
+      aa_in_pf<true, true>( in, pin, out, pout, pf.distance );
+    else
+      aa_in_pf<true, false>( in, pin, out, pout, pf.distance );
+  }
+
   HEDLEY_NO_THROW
   static void aa_meta(
     const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
@@ -144,7 +212,287 @@ struct caware_kernel<T, CONJUGATE_TPL, transpose_kernels::KERNEL_NAME<T, CONJUGA
       aa_out( in, pin, out, pout );
   }
 
-  HEDLEY_NO_THROW   HEDLEY_CONST
+  // pf_in() / pf_out(): with a fixed prefetch mode - independent of prefetch_setting(), for the planner.
+  //   aa_*_pf() if aa_possible(), uu_*_pf() otherwise
+  template <unsigned DISTANCE, bool NTA>
+  HEDLEY_NO_THROW
+  static void pf_in(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+  {
+    if constexpr ( HAS_AA ) {
+      if ( aa_possible( in, pin, out, pout ) ) {
+        aa_in_pf<true, NTA>( in, pin, out, pout, DISTANCE );
+        return;
+      }
+    }
+    uu_in_pf<true, NTA>( in, pin, out, pout, DISTANCE );
+  }
+
+  template <unsigned DISTANCE, bool NTA>
+  HEDLEY_NO_THROW
+  static void pf_out(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+  {
+    if constexpr ( HAS_AA ) {
+      if ( aa_possible( in, pin, out, pout ) ) {
+        aa_out_pf<true, NTA>( in, pin, out, pout, DISTANCE );
+        return;
+      }
+    }
+    uu_out_pf<true, NTA>( in, pin, out, pout, DISTANCE );
+  }
+
+  // tails_out() / tails_in(): the rest of the iterated N x M matrix beyond the grid of full kernels.
+  //   tails of a matrix with at least KERNEL_SZ rows / columns get transposed by full kernels,
+  //   which overlap the grid: these store some values again - identical, as in- and output don't alias.
+  //   narrower tails with the scalar tail_transpose_out() / tail_transpose_in()
+  HEDLEY_NO_THROW
+  static void tails_out(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+  {
+    const unsigned N = out.nRows, M = out.nCols;
+    const unsigned rowSizeB = out.rowSize, rowSizeA = in.rowSize;
+    const unsigned Nf = KERNEL_SZ * ( N / KERNEL_SZ ), Mf = KERNEL_SZ * ( M / KERNEL_SZ );
+    if ( Mf < M && Nf ) {  // tail columns of the full rows
+      if ( Mf )
+        tiles_out<false>( &pin[std::size_t(M - KERNEL_SZ) * rowSizeA], &pout[M - KERNEL_SZ], N / KERNEL_SZ, 1, rowSizeA, rowSizeB );
+      else
+        tail_transpose_out<T, T, CONJUGATE>( pin, pout, Nf, M, rowSizeA, rowSizeB );
+    }
+    if ( Nf < N && M ) {  // tail rows
+      if ( Nf && Mf ) {
+        tiles_out<false>( &pin[N - KERNEL_SZ], &pout[std::size_t(N - KERNEL_SZ) * rowSizeB], 1, M / KERNEL_SZ, rowSizeA, rowSizeB );
+        if ( Mf < M )  // corner
+          tiles_out<false>( &pin[std::size_t(M - KERNEL_SZ) * rowSizeA + N - KERNEL_SZ],
+            &pout[std::size_t(N - KERNEL_SZ) * rowSizeB + M - KERNEL_SZ], 1, 1, rowSizeA, rowSizeB );
+      }
+      else
+        tail_transpose_out<T, T, CONJUGATE>( &pin[Nf], &pout[std::size_t(Nf) * rowSizeB], N - Nf, M, rowSizeA, rowSizeB );
+    }
+  }
+
+  HEDLEY_NO_THROW
+  static void tails_in(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+  {
+    const unsigned N = in.nRows, M = in.nCols;
+    const unsigned rowSizeB = out.rowSize, rowSizeA = in.rowSize;
+    const unsigned Nf = KERNEL_SZ * ( N / KERNEL_SZ ), Mf = KERNEL_SZ * ( M / KERNEL_SZ );
+    if ( Mf < M && Nf ) {  // tail columns of the full rows
+      if ( Mf )
+        tiles_in<false>( &pin[M - KERNEL_SZ], &pout[std::size_t(M - KERNEL_SZ) * rowSizeB], N / KERNEL_SZ, 1, rowSizeA, rowSizeB );
+      else
+        tail_transpose_in<T, T, CONJUGATE>( pin, pout, Nf, M, rowSizeA, rowSizeB );
+    }
+    if ( Nf < N && M ) {  // tail rows
+      if ( Nf && Mf ) {
+        tiles_in<false>( &pin[std::size_t(N - KERNEL_SZ) * rowSizeA], &pout[N - KERNEL_SZ], 1, M / KERNEL_SZ, rowSizeA, rowSizeB );
+        if ( Mf < M )  // corner
+          tiles_in<false>( &pin[std::size_t(N - KERNEL_SZ) * rowSizeA + M - KERNEL_SZ],
+            &pout[std::size_t(M - KERNEL_SZ) * rowSizeB + N - KERNEL_SZ], 1, 1, rowSizeA, rowSizeB );
+      }
+      else
+        tail_transpose_in<T, T, CONJUGATE>( &pin[std::size_t(Nf) * rowSizeA], &pout[Nf], N - Nf, M, rowSizeA, rowSizeB );
+    }
+  }
+
+  // pa_possible(), pa_out() / pa_in(): the aligned kernels for matrices, which only miss the alignment
+  //   of the base pointers: the leading input rows and columns - up to the aligned ones - get peeled off
+  //   and transposed separately. requires row sizes in multiples of KERNEL_SZ, as for aa_possible()
+  HEDLEY_NO_THROW   HEDLEY_PURE
+  static bool pa_possible(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE const T * RESTRICT pout )
+  {
+    if (!HAS_AA)
+      return false;
+    const std::uintptr_t ain = reinterpret_cast<std::uintptr_t>(pin), aout = reinterpret_cast<std::uintptr_t>(pout);
+    if ( (in.rowSize % KERNEL_SZ) | (out.rowSize % KERNEL_SZ) || (ain % sizeof(T)) || (aout % sizeof(T)) )
+      return false;
+    const unsigned c0 = peel( pin ), r0 = peel( pout );
+    return ( in.nRows >= r0 + KERNEL_SZ && in.nCols >= c0 + KERNEL_SZ );
+  }
+
+  // bs: blocked traversal of the aligned core, see bk_out()
+  HEDLEY_NO_THROW
+  static void pa_out(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout, const block_sizes * bs = nullptr )
+  {
+    if ( !pa_possible( in, pin, out, pout ) ) {
+      uu_out( in, pin, out, pout );
+      return;
+    }
+    const unsigned c0 = peel( pin ), r0 = peel( pout );  // #peeled input columns / rows
+    const mat_info core_in { in.nRows - r0, in.nCols - c0, in.rowSize };
+    const mat_info core_out { out.nRows - c0, out.nCols - r0, out.rowSize };
+    const T * core_pin = &pin[std::size_t(r0) * in.rowSize + c0];
+    T * core_pout = &pout[std::size_t(c0) * out.rowSize + r0];
+    if ( bs )
+      blocked_tiles_out( tiles_out<true>, core_pin, core_pout, core_out.nRows / KERNEL_SZ, core_out.nCols / KERNEL_SZ,
+        KERNEL_SZ, in.rowSize, out.rowSize, *bs );
+    else
+      tiles_out<true>( core_pin, core_pout, core_out.nRows / KERNEL_SZ, core_out.nCols / KERNEL_SZ, in.rowSize, out.rowSize );
+    tails_out( core_in, core_pin, core_out, core_pout );
+    peeled( in, pin, out, pout, r0, c0 );
+  }
+
+  HEDLEY_NO_THROW
+  static void pa_in(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout, const block_sizes * bs = nullptr )
+  {
+    if ( !pa_possible( in, pin, out, pout ) ) {
+      uu_in( in, pin, out, pout );
+      return;
+    }
+    const unsigned c0 = peel( pin ), r0 = peel( pout );  // #peeled input columns / rows
+    const mat_info core_in { in.nRows - r0, in.nCols - c0, in.rowSize };
+    const mat_info core_out { out.nRows - c0, out.nCols - r0, out.rowSize };
+    const T * core_pin = &pin[std::size_t(r0) * in.rowSize + c0];
+    T * core_pout = &pout[std::size_t(c0) * out.rowSize + r0];
+    if ( bs )
+      blocked_tiles_in( tiles_in<true>, core_pin, core_pout, core_in.nRows / KERNEL_SZ, core_in.nCols / KERNEL_SZ,
+        KERNEL_SZ, in.rowSize, out.rowSize, *bs );
+    else
+      tiles_in<true>( core_pin, core_pout, core_in.nRows / KERNEL_SZ, core_in.nCols / KERNEL_SZ, in.rowSize, out.rowSize );
+    tails_in( core_in, core_pin, core_out, core_pout );
+    peeled( in, pin, out, pout, r0, c0 );
+  }
+
+  // bt_out() / bt_in(): "bounce tile" mode for conflict prone strides, e.g. row sizes of powers of 2,
+  //   where the KERNEL_SZ rows of each kernel map to the same cache sets:
+  //   copies a block of input rows into a small, aligned buffer in L1 - with row size bounce_side() + KERNEL_SZ,
+  //   which spreads the rows over the cache sets - transposes with the aligned kernel into a 2nd buffer,
+  //   from where the output rows get copied out. the strided matrices are only accessed row by row,
+  //   whatever their row sizes or alignment. BOUNCE_BYTES is the (max) size of each buffer
+  static constexpr unsigned BOUNCE_BYTES = 16384;
+
+  HEDLEY_NO_THROW
+  static void bt_out(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+  {
+    bounce<false>( in, pin, out, pout );
+  }
+
+  HEDLEY_NO_THROW
+  static void bt_in(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+  {
+    bounce<true>( in, pin, out, pout );
+  }
+
+  // bk_out() / bk_in(): uu_out() / uu_in() - or aa_*() / pa_*(), if possible - with the grid of full kernels
+  //   in L1 and L2 / TLB sized blocks of tiles, see transpose_blocked.hpp
+  HEDLEY_NO_THROW
+  static void bk_out(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout, const block_sizes &bs )
+  {
+    const unsigned N = out.nRows, M = out.nCols;
+    const unsigned rowSizeB = out.rowSize, rowSizeA = in.rowSize;
+    if constexpr ( HAS_AA ) {
+      if ( aa_possible( in, pin, out, pout ) ) {
+        blocked_tiles_out( tiles_out<true>, pin, pout,
+          (N + KERNEL_SZ - 1) / KERNEL_SZ, (M + KERNEL_SZ - 1) / KERNEL_SZ, KERNEL_SZ, rowSizeA, rowSizeB, bs );
+        return;
+      }
+      if ( pa_possible( in, pin, out, pout ) ) {
+        pa_out( in, pin, out, pout, &bs );
+        return;
+      }
+    }
+    blocked_tiles_out( tiles_out<false>, pin, pout, N / KERNEL_SZ, M / KERNEL_SZ, KERNEL_SZ, rowSizeA, rowSizeB, bs );
+    tails_out( in, pin, out, pout );
+  }
+
+  HEDLEY_NO_THROW
+  static void bk_in(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout, const block_sizes &bs )
+  {
+    const unsigned N = in.nRows, M = in.nCols;
+    const unsigned rowSizeB = out.rowSize, rowSizeA = in.rowSize;
+    if constexpr ( HAS_AA ) {
+      if ( aa_possible( in, pin, out, pout ) ) {
+        blocked_tiles_in( tiles_in<true>, pin, pout,
+          (N + KERNEL_SZ - 1) / KERNEL_SZ, (M + KERNEL_SZ - 1) / KERNEL_SZ, KERNEL_SZ, rowSizeA, rowSizeB, bs );
+        return;
+      }
+      if ( pa_possible( in, pin, out, pout ) ) {
+        pa_in( in, pin, out, pout, &bs );
+        return;
+      }
+    }
+    blocked_tiles_in( tiles_in<false>, pin, pout, N / KERNEL_SZ, M / KERNEL_SZ, KERNEL_SZ, rowSizeA, rowSizeB, bs );
+    tails_in( in, pin, out, pout );
+  }
+
+  // tiles_out() / tiles_in(): only the grid of nTileRows x nTileCols full kernels - without tails
+  //   for precomputed schedules, see transpose_plan.hpp
+  //   ALIGNED requires the same as aa_*(), which are the grids with #rows and #cols rounded up
+  //   the macro kernels have no streaming stores: see HAS_NT
+  template <bool ALIGNED, bool STREAM = false>
+  HEDLEY_NO_THROW
+  static void tiles_out(
+    NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout,
+    const unsigned nTileRows, const unsigned nTileCols,
+    const unsigned rowSizeA, const unsigned rowSizeB )
+  {
+    // iterate linearly through output matrix indices
+    const unsigned N = KERNEL_SZ * nTileRows, M = KERNEL_SZ * nTileCols;
+    const unsigned out_inc = KERNEL_SZ * rowSizeB, in_inc = KERNEL_SZ * rowSizeA;
+    unsigned out_row_off, in_row_off, row, col;
+    static_assert( !STREAM, "" );
+
+    KERNEL_INIT();
+    for( row = out_row_off = 0; row < N; row += KERNEL_SZ, out_row_off += out_inc ) {
+      for( col = in_row_off = 0; col < M; col += KERNEL_SZ, in_row_off += in_inc ) {
+        const T * RESTRICT A_ = &pin[in_row_off+row];
+        T * RESTRICT B_ = &pout[out_row_off+col];
+        if constexpr ( ALIGNED ) {
+          KERNEL_OP_AA();
+        } else {
+          KERNEL_OP_UU();
+        }
+      }
+    }
+  }
+
+  template <bool ALIGNED, bool STREAM = false>
+  HEDLEY_NO_THROW
+  static void tiles_in(
+    NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout,
+    const unsigned nTileRows, const unsigned nTileCols,
+    const unsigned rowSizeA, const unsigned rowSizeB )
+  {
+    // iterate linearly through input matrix indices
+    const unsigned N = KERNEL_SZ * nTileRows, M = KERNEL_SZ * nTileCols;
+    const unsigned out_inc = KERNEL_SZ * rowSizeB, in_inc = KERNEL_SZ * rowSizeA;
+    unsigned out_row_off, in_row_off, row, col;
+    static_assert( !STREAM, "" );
+
+    KERNEL_INIT();
+    for( row = in_row_off = 0; row < N; row += KERNEL_SZ, in_row_off += in_inc ) {
+      for( col = out_row_off = 0; col < M; col += KERNEL_SZ, out_row_off += out_inc ) {
+        const T * RESTRICT A_ = &pin[in_row_off+col];
+        T * RESTRICT B_ = &pout[out_row_off+row];
+        if constexpr ( ALIGNED ) {
+          KERNEL_OP_AA();
+        } else {
+          KERNEL_OP_UU();
+        }
+      }
+    }
+  }
+
+  HEDLEY_NO_THROW   HEDLEY_PURE
   static bool aa_possible(
     const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
     const mat_info &out, NO_ESCAPE const T * RESTRICT pout )
@@ -152,8 +500,10 @@ struct caware_kernel<T, CONJUGATE_TPL, transpose_kernels::KERNEL_NAME<T, CONJUGA
     if (!HAS_AA)
       return false;
 
-    unsigned out_mod = (out.rowSize % KERNEL_SZ);
-    unsigned in_mod = (in.rowSize % KERNEL_SZ);
+    // aa_in() / aa_out() round up #rows and #cols to multiples of KERNEL_SZ:
+    //   the padding of rowSize covers the columns, but there are no rows beyond nRows
+    unsigned out_mod = (out.rowSize % KERNEL_SZ) | (out.nRows % KERNEL_SZ);
+    unsigned in_mod = (in.rowSize % KERNEL_SZ) | (in.nRows % KERNEL_SZ);
 
     std::size_t space_inp = in.nRows * in.rowSize * sizeof(T);
     void * raw_inp = const_cast<T*>(pin);
@@ -166,6 +516,70 @@ struct caware_kernel<T, CONJUGATE_TPL, transpose_kernels::KERNEL_NAME<T, CONJUGA
     return ( (!out_mod && !in_mod) && (raw_inp == res_inp) && (raw_out == res_out) );
   }
 
+private:
+  // #elements from p to the next KERNEL_SZ * sizeof(T) aligned address
+  static unsigned peel( const T * p )
+  {
+    constexpr std::uintptr_t A = KERNEL_SZ * sizeof(T);
+    return unsigned( ( ( A - reinterpret_cast<std::uintptr_t>(p) % A ) % A ) / sizeof(T) );
+  }
+
+  static constexpr unsigned bounce_side()
+  {
+    unsigned s = KERNEL_SZ;
+    while ( ( s + KERNEL_SZ ) * ( s + 2 * KERNEL_SZ ) * sizeof(T) <= BOUNCE_BYTES )
+      s += KERNEL_SZ;
+    return s;
+  }
+
+  // blocks of bounce_side() x bounce_side() input elements, iterating input or output order:
+  //   input block -> buffer A -> kernels -> buffer B -> output block
+  template <bool IN_ORDER>
+  HEDLEY_NO_THROW
+  static void bounce(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+  {
+    constexpr unsigned S = bounce_side(), BS = S + KERNEL_SZ;
+    static_assert( KERNEL_SZ * sizeof(T) <= 64, "alignment of bounce buffers is insufficient for the kernel" );
+    // uninitialized: no construction of T
+    alignas(64) unsigned char raw_a[ S * BS * sizeof(T) ];
+    alignas(64) unsigned char raw_b[ S * BS * sizeof(T) ];
+    T * RESTRICT buf_a = reinterpret_cast<T *>( raw_a );
+    T * RESTRICT buf_b = reinterpret_cast<T *>( raw_b );
+
+    const unsigned N = in.nRows, M = in.nCols;
+    for ( unsigned a = 0; a < ( IN_ORDER ? N : M ); a += S ) {
+      for ( unsigned b = 0; b < ( IN_ORDER ? M : N ); b += S ) {
+        const unsigned R0 = IN_ORDER ? a : b, C0 = IN_ORDER ? b : a;
+        const unsigned nR = ( N - R0 < S ) ? N - R0 : S, nC = ( M - C0 < S ) ? M - C0 : S;
+        const T * bin = &pin[std::size_t(R0) * in.rowSize + C0];
+        T * bout = &pout[std::size_t(C0) * out.rowSize + R0];
+        for ( unsigned r = 0; r < nR; ++r )
+          bounce_copy<KERNEL_SZ>( &buf_a[r * BS], &bin[std::size_t(r) * in.rowSize], nC );
+        tiles_out<HAS_AA>( buf_a, buf_b, nC / KERNEL_SZ, nR / KERNEL_SZ, BS, BS );
+        tails_out( mat_info { nR, nC, BS }, buf_a, mat_info { nC, nR, BS }, buf_b );
+        for ( unsigned r = 0; r < nC; ++r )
+          bounce_copy<KERNEL_SZ>( &bout[std::size_t(r) * out.rowSize], &buf_b[r * BS], nR );
+      }
+    }
+  }
+
+  // the peeled rims of pa_out() / pa_in(): the r0 leading input rows - iterating the contiguous input,
+  //   and the c0 leading input columns of the remaining rows - iterating the contiguous output.
+  //   both get widened to KERNEL_SZ: full kernels, overlapping the core, see tails_out()
+  HEDLEY_NO_THROW
+  static void peeled(
+    const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+    const mat_info &out, NO_ESCAPE T * RESTRICT pout, const unsigned r0, const unsigned c0 )
+  {
+    if ( r0 )
+      uu_in( mat_info { KERNEL_SZ, in.nCols, in.rowSize }, pin, mat_info { out.nRows, KERNEL_SZ, out.rowSize }, pout );
+    if ( c0 )
+      uu_out( mat_info { in.nRows - r0, KERNEL_SZ, in.rowSize }, &pin[std::size_t(r0) * in.rowSize],
+        mat_info { KERNEL_SZ, in.nRows - r0, out.rowSize }, &pout[r0] );
+  }
+
 };
 
 
@@ -4,6 +4,8 @@
 #include "transpose_defs.hpp"
 #include "transpose_cache_aware_tails.hpp"
 #include <complex>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 
 
@@ -153,4 +155,136 @@ static void cache_oblivious_meta(
 }
 
 
+// cache oblivious recursion with SIMD kernel leaves: CK is a caware_kernel<T, CONJUGATE, KERNEL>.
+//   the splits are at multiples of CK::KERNEL_SZ - the recursion stops at blocks of at most base x base elements,
+//   which get transposed with the kernel's full tiles - the aligned kernel, if ALIGNED - and the kernel's tails.
+//   not static: raw_kernel_wrapper<>, with external linkage, calls these
+template <class T, class CK, bool ALIGNED>
+HEDLEY_NO_THROW
+void cache_oblivious_kernel_in(
+  NO_ESCAPE const mats_info<T,T> & RESTRICT io,
+  const unsigned row_off, const unsigned col_off,
+  const unsigned nRows, const unsigned nCols, const unsigned base
+) {
+  constexpr unsigned K = CK::KERNEL_SZ;
+  if ( nCols > base || nRows > base ) {
+    // nRows > base >= K: halfRows is in [K, nRows)
+    if( nRows >= nCols ) {
+      const unsigned halfRows = K * ( ( nRows / K + 1U ) / 2U );
+      cache_oblivious_kernel_in<T, CK, ALIGNED>( io, row_off, col_off, halfRows, nCols, base );
+      cache_oblivious_kernel_in<T, CK, ALIGNED>( io, row_off +halfRows, col_off, nRows - halfRows, nCols, base );
+    } else {
+      const unsigned halfCols = K * ( ( nCols / K + 1U ) / 2U );
+      cache_oblivious_kernel_in<T, CK, ALIGNED>( io, row_off, col_off, nRows, halfCols, base );
+      cache_oblivious_kernel_in<T, CK, ALIGNED>( io, row_off, col_off +halfCols, nRows, nCols - halfCols, base );
+    }
+  } else {
+    const unsigned rowSize_in = io.rowSize_in;
+    const unsigned rowSize_out = io.rowSize_out;
+    T * RESTRICT pout = io.pout + std::size_t(col_off) * rowSize_out + row_off;
+    const T * RESTRICT pin = io.pin + std::size_t(row_off) * rowSize_in + col_off;
+    CK::template tiles_in<ALIGNED>( pin, pout, nRows / K, nCols / K, rowSize_in, rowSize_out );
+    CK::tails_in( mat_info { nRows, nCols, rowSize_in }, pin, mat_info { nCols, nRows, rowSize_out }, pout );
+  }
+}
+
+
+template <class T, class CK, bool ALIGNED>
+HEDLEY_NO_THROW
+void cache_oblivious_kernel_out(
+  NO_ESCAPE const mats_info<T,T> & RESTRICT io,
+  const unsigned row_off, const unsigned col_off,
+  const unsigned nRows, const unsigned nCols, const unsigned base
+) {
+  constexpr unsigned K = CK::KERNEL_SZ;
+  if ( nCols > base || nRows > base ) {
+    if( nRows >= nCols ) {
+      const unsigned halfRows = K * ( ( nRows / K + 1U ) / 2U );
+      cache_oblivious_kernel_out<T, CK, ALIGNED>( io, row_off, col_off, halfRows, nCols, base );
+      cache_oblivious_kernel_out<T, CK, ALIGNED>( io, row_off +halfRows, col_off, nRows - halfRows, nCols, base );
+    } else {
+      const unsigned halfCols = K * ( ( nCols / K + 1U ) / 2U );
+      cache_oblivious_kernel_out<T, CK, ALIGNED>( io, row_off, col_off, nRows, halfCols, base );
+      cache_oblivious_kernel_out<T, CK, ALIGNED>( io, row_off, col_off +halfCols, nRows, nCols - halfCols, base );
+    }
+  } else {
+    const unsigned rowSize_in = io.rowSize_in;
+    const unsigned rowSize_out = io.rowSize_out;
+    T * RESTRICT pout = io.pout + std::size_t(row_off) * rowSize_out + col_off;
+    const T * RESTRICT pin = io.pin + std::size_t(col_off) * rowSize_in + row_off;
+    CK::template tiles_out<ALIGNED>( pin, pout, nRows / K, nCols / K, rowSize_in, rowSize_out );
+    CK::tails_out( mat_info { nCols, nRows, rowSize_in }, pin, mat_info { nRows, nCols, rowSize_out }, pout );
+  }
+}
+
+
+// default base case of the recursion with kernel leaves: in kernel sizes
+static constexpr unsigned CO_KERNEL_BASE = 8;
+
+// base: 0 for CO_KERNEL_BASE kernels, else rounded up to a multiple of the kernel size.
+//   the leaves use the aligned kernel, when both row sizes are multiples of the kernel size and the pointers aligned:
+//   the block offsets are multiples of the kernel size, too
+template <class T, class CK>
+HEDLEY_PURE
+bool cache_oblivious_kernel_aligned(
+  const mat_info &in, const T * pin, const mat_info &out, const T * pout )
+{
+  constexpr std::uintptr_t A = CK::KERNEL_SZ * sizeof(T);
+  return CK::HAS_AA && !( in.rowSize % CK::KERNEL_SZ ) && !( out.rowSize % CK::KERNEL_SZ )
+    && !( reinterpret_cast<std::uintptr_t>(pin) % A ) && !( reinterpret_cast<std::uintptr_t>(pout) % A );
+}
+
+template <class T, class CK>
+HEDLEY_NO_THROW
+void cache_oblivious_kernel_in(
+  const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+  const mat_info &out, NO_ESCAPE T * RESTRICT pout, const unsigned base = 0 )
+{
+  constexpr unsigned K = CK::KERNEL_SZ;
+  const unsigned b = base ? K * ( ( base + K - 1 ) / K ) : CO_KERNEL_BASE * K;
+  const mats_info<T,T> io {
+    pin, pout,
+    in.nRows, in.nCols, in.rowSize,
+    out.nRows, out.nCols, out.rowSize
+  };
+  if constexpr ( CK::HAS_AA ) {
+    if ( cache_oblivious_kernel_aligned<T, CK>( in, pin, out, pout ) )
+      return cache_oblivious_kernel_in<T, CK, true>( io, 0, 0, in.nRows, in.nCols, b );
+  }
+  cache_oblivious_kernel_in<T, CK, false>( io, 0, 0, in.nRows, in.nCols, b );
+}
+
+template <class T, class CK>
+HEDLEY_NO_THROW
+void cache_oblivious_kernel_out(
+  const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+  const mat_info &out, NO_ESCAPE T * RESTRICT pout, const unsigned base = 0 )
+{
+  constexpr unsigned K = CK::KERNEL_SZ;
+  const unsigned b = base ? K * ( ( base + K - 1 ) / K ) : CO_KERNEL_BASE * K;
+  const mats_info<T,T> io {
+    pin, pout,
+    in.nRows, in.nCols, in.rowSize,
+    out.nRows, out.nCols, out.rowSize
+  };
+  if constexpr ( CK::HAS_AA ) {
+    if ( cache_oblivious_kernel_aligned<T, CK>( in, pin, out, pout ) )
+      return cache_oblivious_kernel_out<T, CK, true>( io, 0, 0, out.nRows, out.nCols, b );
+  }
+  cache_oblivious_kernel_out<T, CK, false>( io, 0, 0, out.nRows, out.nCols, b );
+}
+
+template <class T, class CK>
+HEDLEY_NO_THROW
+void cache_oblivious_kernel_meta(
+  const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+  const mat_info &out, NO_ESCAPE T * RESTRICT pout, const unsigned base = 0 )
+{
+  if ( in.nRows < in.nCols )
+    cache_oblivious_kernel_in<T, CK>( in, pin, out, pout, base );
+  else
+    cache_oblivious_kernel_out<T, CK>( in, pin, out, pout, base );
+}
+
+
 }
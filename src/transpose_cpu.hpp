@@ -0,0 +1,163 @@
+
+#pragma once
+
+#include "transpose_defs.hpp"
+
+#include <cpu_features_macros.h>
+
+#include <cstdio>
+#include <vector>
+
+#if defined(CPU_FEATURES_ARCH_AARCH64)
+#  include <cpuinfo_aarch64.h>
+#elif defined(CPU_FEATURES_ARCH_ARM)
+#  include <cpuinfo_arm.h>
+#elif defined(CPU_FEATURES_ARCH_X86)
+#  include <cpuinfo_x86.h>
+#endif
+
+
+namespace transpose
+{
+
+// SIMD capabilities of the executing CPU - independent of the compiler flags
+//   on ARM, the SSE* flags tell, that the kernels are usable through sse2neon
+struct cpu_caps
+{
+  bool sse;
+  bool sse2;
+  bool ssse3;
+  bool sse41;
+  bool avx;
+  bool avx2;
+  bool avx512f;
+  bool avx512bw;
+  bool neon;
+};
+
+
+// detects the CPU capabilities with cpu_features - only once, at first call
+inline const cpu_caps & detected_cpu_caps()
+{
+  static const cpu_caps caps = [] () {
+    cpu_caps c { false, false, false, false, false, false, false, false, false };
+#if defined(CPU_FEATURES_ARCH_X86)
+    const auto f = cpu_features::GetX86Info().features;
+    c.sse      = f.sse;
+    c.sse2     = c.sse && f.sse2;
+    c.ssse3    = c.sse2 && f.sse3 && f.ssse3;
+    c.sse41    = c.ssse3 && f.sse4_1;
+    c.avx      = c.sse41 && f.sse4_2 && f.avx;
+    c.avx2     = c.avx && f.avx2;
+    c.avx512f  = c.avx2 && f.avx512f;
+    c.avx512bw = c.avx512f && f.avx512bw;
+#elif defined(CPU_FEATURES_ARCH_AARCH64)
+    const auto f = cpu_features::GetAarch64Info().features;
+    c.neon = f.asimd;
+    c.sse = c.sse2 = c.ssse3 = c.sse41 = c.neon;  // through sse2neon
+#elif defined(CPU_FEATURES_ARCH_ARM)
+    const auto f = cpu_features::GetArmInfo().features;
+    c.neon = f.neon && f.vfpv3;
+    c.sse = c.sse2 = c.ssse3 = c.sse41 = c.neon;  // through sse2neon
+#endif
+    return c;
+  } ();
+  return caps;
+}
+
+
+// data cache and TLB sizes of the executing CPU - for blocking, see transpose_blocked.hpp
+//   with defaults of typical cores, for what cpu_features doesn't report
+struct cpu_cache_info
+{
+  unsigned l1d;          // bytes of the level 1 data cache
+  unsigned l2;           // bytes of the level 2 data / unified cache
+  unsigned tlb_entries;  // #entries of the largest data TLB for 4 KB pages
+  unsigned line_size;    // bytes of a level 1 data cache line
+};
+
+
+// detects the cache sizes with cpu_features - only once, at first call
+inline const cpu_cache_info & detected_cpu_caches()
+{
+  static const cpu_cache_info info = [] () {
+    cpu_cache_info c { 32U << 10, 256U << 10, 64, 64 };
+#if defined(CPU_FEATURES_ARCH_X86)
+    const cpu_features::CacheInfo ci = cpu_features::GetX86CacheInfo();
+    for ( int k = 0; k < ci.size && k < CPU_FEATURES_MAX_CACHE_LEVEL; ++k ) {
+      const cpu_features::CacheLevelInfo &l = ci.levels[k];
+      const bool data = ( l.cache_type == cpu_features::CPU_FEATURE_CACHE_DATA
+        || l.cache_type == cpu_features::CPU_FEATURE_CACHE_UNIFIED );
+      const bool tlb = ( l.cache_type == cpu_features::CPU_FEATURE_CACHE_TLB
+        || l.cache_type == cpu_features::CPU_FEATURE_CACHE_DTLB
+        || l.cache_type == cpu_features::CPU_FEATURE_CACHE_STLB );
+      if ( data && l.level == 1 && l.cache_size > 0 ) {
+        c.l1d = unsigned(l.cache_size);
+        if ( l.line_size > 0 )
+          c.line_size = unsigned(l.line_size);
+      }
+      else if ( data && l.level == 2 && l.cache_size > 0 )
+        c.l2 = unsigned(l.cache_size);
+      else if ( tlb && l.cache_size == 4096 && l.tlb_entries > int(c.tlb_entries) )  // cache_size is the page size
+        c.tlb_entries = unsigned(l.tlb_entries);
+    }
+#endif
+    return c;
+  } ();
+  return info;
+}
+
+
+// NUMA nodes of the executing machine, with their CPUs - from sysfs on Linux.
+//   a single node without CPUs elsewhere - or when sysfs isn't readable
+struct numa_node
+{
+  unsigned id;                  // node number of the OS
+  std::vector<unsigned> cpus;   // logical CPU numbers
+};
+
+
+// parses a sysfs list, e.g. "0-7,16-23", into the numbers
+inline std::vector<unsigned> parse_sysfs_list( const char * path )
+{
+  std::vector<unsigned> v;
+  std::FILE * f = std::fopen( path, "r" );
+  if ( !f )
+    return v;
+  unsigned a, b;
+  int n;
+  while ( ( n = std::fscanf( f, "%u-%u", &a, &b ) ) >= 1 ) {
+    if ( n == 1 )
+      b = a;
+    for ( unsigned k = a; k <= b; ++k )
+      v.push_back( k );
+    if ( std::fgetc( f ) != ',' )
+      break;
+  }
+  std::fclose( f );
+  return v;
+}
+
+
+// detects the NUMA nodes - only once, at first call
+inline const std::vector<numa_node> & detected_numa_nodes()
+{
+  static const std::vector<numa_node> nodes = [] () {
+    std::vector<numa_node> v;
+#if defined(__linux__)
+    char path[96];
+    for ( unsigned id : parse_sysfs_list( "/sys/devices/system/node/online" ) ) {
+      std::snprintf( path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", id );
+      numa_node n { id, parse_sysfs_list( path ) };
+      if ( !n.cpus.empty() )  // memory only nodes
+        v.push_back( n );
+    }
+#endif
+    if ( v.empty() )
+      v.push_back( numa_node { 0, std::vector<unsigned>() } );
+    return v;
+  } ();
+  return nodes;
+}
+
+}
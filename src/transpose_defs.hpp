@@ -8,6 +8,10 @@
 #define RESTRICT       HEDLEY_RESTRICT
 #define NO_ESCAPE      HEDLEY_NO_ESCAPE
 
+#if defined(_MSC_VER) && !defined(__clang__) && ( defined(_M_X64) || defined(_M_IX86) )
+#include <xmmintrin.h>
+#endif
+
 
 namespace transpose
 {
@@ -32,4 +36,19 @@ constexpr unsigned numElemsInCacheLine()
   return ( sizeof(T) < CACHE_LINE_SZ ) ? ( CACHE_LINE_SZ / sizeof(T) ) : 1U;
 }
 
+// software prefetch of the cache line at p: for a later read or write.
+//   NTA: non-temporal, e.g. prefetchnta on x86 - into the nearest cache, with minimal pollution of the others
+//   without: into all cache levels, e.g. prefetcht0
+template <bool WRITE, bool NTA>
+ALWAYS_INLINE void prefetch( const void * p )
+{
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch( p, WRITE ? 1 : 0, NTA ? 0 : 3 );
+#elif defined(_MSC_VER) && ( defined(_M_X64) || defined(_M_IX86) )
+  _mm_prefetch( static_cast<const char *>(p), NTA ? _MM_HINT_NTA : _MM_HINT_T0 );
+#else
+  (void)p;
+#endif
+}
+
 }
@@ -0,0 +1,532 @@
+
+#pragma once
+
+// runtime dispatch: select the best kernel for the executing CPU
+//   - by element size, alignment and conjugation
+//   - header only: from the kernels, which are compiled into this translation unit
+//   - with TRANSPOSE_USE_LIB: from the library's kernels, compiled for multiple instruction sets
+
+#include "transpose_defs.hpp"
+#include "transpose_cpu.hpp"
+#include "transpose_tpl.hpp"
+#include "transpose_blocked.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <complex>
+#include <type_traits>
+
+
+namespace transpose
+{
+
+// type erased transpose functions: the kernels only depend on the element size
+typedef void (*raw_transpose_fn)(
+  const mat_info &in, const void * pin,
+  const mat_info &out, void * pout );
+
+// grid of nTileRows x nTileCols full kernels, without tails: see caware_kernel::tiles_out()
+typedef void (*raw_tiles_fn)(
+  const void * pin, void * pout,
+  unsigned nTileRows, unsigned nTileCols,
+  unsigned rowSizeA, unsigned rowSizeB );
+
+typedef bool (*raw_aa_possible_fn)(
+  const mat_info &in, const void * pin,
+  const mat_info &out, const void * pout );
+
+
+// the fixed prefetch modes of dispatch_entry::pf_in[] / pf_out[], which the planner measures
+static constexpr unsigned NUM_PREFETCH_VARIANTS = 3;
+static constexpr prefetch_mode prefetch_variants[NUM_PREFETCH_VARIANTS] = {
+  { 2, false }, { 8, false }, { 8, true }
+};
+
+
+struct dispatch_entry
+{
+  const char * name;      // kernel name, e.g. "AVX_8x8x32"
+  unsigned kernel_sz;     // KERNEL_SZ; width/height of the kernel's square block
+  raw_transpose_fn uu_in;
+  raw_transpose_fn uu_out;
+  raw_transpose_fn aa_in;   // nullptr without aligned kernel
+  raw_transpose_fn aa_out;  // nullptr without aligned kernel
+  raw_aa_possible_fn aa_possible;
+  raw_tiles_fn tiles_uu_in;   // nullptr without kernel, e.g. caware
+  raw_tiles_fn tiles_uu_out;
+  raw_tiles_fn tiles_aa_in;   // nullptr without aligned kernel
+  raw_tiles_fn tiles_aa_out;
+  raw_transpose_fn nt_in;     // nullptr without streaming stores; requires aa_possible()
+  raw_transpose_fn nt_out;
+  raw_tiles_fn tiles_nt_in;   // nullptr without streaming stores
+  raw_tiles_fn tiles_nt_out;
+  raw_transpose_fn pf_in[NUM_PREFETCH_VARIANTS];   // with prefetch_variants[]; nullptrs without kernel
+  raw_transpose_fn pf_out[NUM_PREFETCH_VARIANTS];
+  raw_transpose_fn bk_in;     // blocked for L1 / L2 / TLB: nullptr without kernel
+  raw_transpose_fn bk_out;
+  raw_transpose_fn pa_in;     // peeling to the aligned kernel: nullptr without aligned kernel. falls back to uu
+  raw_transpose_fn pa_out;
+  raw_transpose_fn bt_in;     // bounce tiles for conflict prone strides: nullptr without kernel
+  raw_transpose_fn bt_out;
+  raw_transpose_fn co_in;     // cache oblivious recursion with kernel leaves: nullptr without kernel
+  raw_transpose_fn co_out;
+};
+
+
+// output size in bytes, from which transpose() and plan use the streaming stores of the kernel - if it has.
+//   streaming stores avoid the read for ownership of the output, but are slow, when the output
+//   would have fit into the caches. the default of 32 MB is beyond typical last level caches.
+//   set it before transposing
+inline std::size_t & streaming_store_threshold()
+{
+  static std::size_t bytes = std::size_t(32) << 20;
+  return bytes;
+}
+
+
+#ifdef TRANSPOSE_USE_LIB
+
+// block sizes in tiles for the kernel size - from the detected caches
+//   implemented in the library's baseline translation unit: the kernel wrappers of each
+//   instruction set call it - an inline copy would get compiled with their flags
+block_sizes detected_block_sizes( unsigned elemSize, unsigned kernelSz );
+
+#else
+
+// block sizes in tiles for the kernel size - from the detected caches
+inline block_sizes detected_block_sizes( unsigned elemSize, unsigned kernelSz )
+{
+  const cpu_cache_info &c = detected_cpu_caches();
+  return calc_block_sizes( elemSize, kernelSz, c.l1d, c.l2, c.tlb_entries );
+}
+
+#endif
+
+// output size in bytes, from which transpose() and plan use the blocked traversal: beyond the L2 cache
+inline std::size_t blocking_threshold()
+{
+  return detected_cpu_caches().l2;
+}
+
+
+// wraps caware_kernel<> (or similar) class TRANSPOSE_CLASS into dispatch_entry
+template <class T, class TRANSPOSE_CLASS>
+struct raw_kernel_wrapper
+{
+  static void uu_in( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    TRANSPOSE_CLASS::uu_in( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void uu_out( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    TRANSPOSE_CLASS::uu_out( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void aa_in( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    TRANSPOSE_CLASS::aa_in( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void aa_out( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    TRANSPOSE_CLASS::aa_out( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static bool aa_possible( const mat_info &in, const void * pin, const mat_info &out, const void * pout ) {
+    return TRANSPOSE_CLASS::aa_possible( in, static_cast<const T *>(pin), out, static_cast<const T *>(pout) );
+  }
+  static void nt_in( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    TRANSPOSE_CLASS::nt_in( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void nt_out( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    TRANSPOSE_CLASS::nt_out( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void bk_in( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    static const block_sizes bs = detected_block_sizes( sizeof(T), TRANSPOSE_CLASS::KERNEL_SZ );
+    TRANSPOSE_CLASS::bk_in( in, static_cast<const T *>(pin), out, static_cast<T *>(pout), bs );
+  }
+  static void bk_out( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    static const block_sizes bs = detected_block_sizes( sizeof(T), TRANSPOSE_CLASS::KERNEL_SZ );
+    TRANSPOSE_CLASS::bk_out( in, static_cast<const T *>(pin), out, static_cast<T *>(pout), bs );
+  }
+  static void pa_in( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    TRANSPOSE_CLASS::pa_in( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void pa_out( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    TRANSPOSE_CLASS::pa_out( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void bt_in( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    TRANSPOSE_CLASS::bt_in( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void bt_out( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    TRANSPOSE_CLASS::bt_out( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void co_in( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    cache_oblivious_kernel_in<T, TRANSPOSE_CLASS>( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void co_out( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    cache_oblivious_kernel_out<T, TRANSPOSE_CLASS>( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  template <unsigned V>
+  static void pf_in( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    TRANSPOSE_CLASS::template pf_in<prefetch_variants[V].distance, prefetch_variants[V].nta>( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  template <unsigned V>
+  static void pf_out( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    TRANSPOSE_CLASS::template pf_out<prefetch_variants[V].distance, prefetch_variants[V].nta>( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  template <bool ALIGNED, bool STREAM = false>
+  static void tiles_in( const void * pin, void * pout, unsigned nTileRows, unsigned nTileCols, unsigned rowSizeA, unsigned rowSizeB ) {
+    TRANSPOSE_CLASS::template tiles_in<ALIGNED, STREAM>( static_cast<const T *>(pin), static_cast<T *>(pout), nTileRows, nTileCols, rowSizeA, rowSizeB );
+  }
+  template <bool ALIGNED, bool STREAM = false>
+  static void tiles_out( const void * pin, void * pout, unsigned nTileRows, unsigned nTileCols, unsigned rowSizeA, unsigned rowSizeB ) {
+    TRANSPOSE_CLASS::template tiles_out<ALIGNED, STREAM>( static_cast<const T *>(pin), static_cast<T *>(pout), nTileRows, nTileCols, rowSizeA, rowSizeB );
+  }
+
+  static dispatch_entry entry( const char * name ) {
+    if constexpr ( TRANSPOSE_CLASS::HAS_NT )
+      return dispatch_entry { name, TRANSPOSE_CLASS::KERNEL_SZ, uu_in, uu_out, aa_in, aa_out, aa_possible,
+        tiles_in<false>, tiles_out<false>, tiles_in<true>, tiles_out<true>,
+        nt_in, nt_out, tiles_in<true, true>, tiles_out<true, true>,
+        { pf_in<0>, pf_in<1>, pf_in<2> }, { pf_out<0>, pf_out<1>, pf_out<2> },
+        bk_in, bk_out, pa_in, pa_out, bt_in, bt_out, co_in, co_out };
+    else if ( TRANSPOSE_CLASS::HAS_AA )
+      return dispatch_entry { name, TRANSPOSE_CLASS::KERNEL_SZ, uu_in, uu_out, aa_in, aa_out, aa_possible,
+        tiles_in<false>, tiles_out<false>, tiles_in<true>, tiles_out<true>,
+        nullptr, nullptr, nullptr, nullptr,
+        { pf_in<0>, pf_in<1>, pf_in<2> }, { pf_out<0>, pf_out<1>, pf_out<2> },
+        bk_in, bk_out, pa_in, pa_out, bt_in, bt_out, co_in, co_out };
+    else
+      return dispatch_entry { name, TRANSPOSE_CLASS::KERNEL_SZ, uu_in, uu_out, nullptr, nullptr, aa_possible,
+        tiles_in<false>, tiles_out<false>, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr,
+        { pf_in<0>, pf_in<1>, pf_in<2> }, { pf_out<0>, pf_out<1>, pf_out<2> },
+        bk_in, bk_out, nullptr, nullptr, bt_in, bt_out, co_in, co_out };
+  }
+};
+
+// wraps the non-SIMD cache aware caware_in() / caware_out()
+template <class T>
+struct raw_caware_wrapper
+{
+  static void uu_in( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    caware_in<T, T>( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void uu_out( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    caware_out<T, T>( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static bool aa_possible( const mat_info &, const void *, const mat_info &, const void * ) {
+    return false;
+  }
+
+  static dispatch_entry entry( const char * name ) {
+    return dispatch_entry { name, numElemsInCacheLine<T>(), uu_in, uu_out, nullptr, nullptr, aa_possible,
+      nullptr, nullptr, nullptr, nullptr,
+      nullptr, nullptr, nullptr, nullptr,
+      { nullptr, nullptr, nullptr }, { nullptr, nullptr, nullptr },
+      nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+  }
+};
+
+
+// element types, with which the type erased kernels get instantiated
+template <unsigned ELEM_SZ, bool CONJUGATE> struct dispatch_type { };
+template <> struct dispatch_type< 1, false> { using type = uint8_t; };
+template <> struct dispatch_type< 2, false> { using type = uint16_t; };
+template <> struct dispatch_type< 4, false> { using type = uint32_t; };
+template <> struct dispatch_type< 8, false> { using type = uint64_t; };
+template <> struct dispatch_type< 8, true > { using type = std::complex<float>; };
+template <> struct dispatch_type<16, false> { using type = std::complex<double>; };
+template <> struct dispatch_type<16, true > { using type = std::complex<double>; };
+
+
+struct dispatch_table
+{
+  // index with [ld(element size)][conjugate]: element sizes 1, 2, 4, 8 and 16 bytes
+  dispatch_entry e[5][2];
+  bool valid[5][2];
+};
+
+
+// the dispatch_register_*() functions fill the table entries, for which kernels are compiled in
+//   and supported by the CPU. registration order is generic, sse, sse41, neon, avx, avx2, avx512: later ones overwrite
+//   the library compiles each of them in it's own translation unit with matching compiler flags:
+//   there, only the unit's TRANSPOSE_ISA_* selects it's function - no unit instantiates other instruction sets' kernels
+
+#if !defined(TRANSPOSE_USE_LIB) || defined(TRANSPOSE_ISA_GENERIC)
+inline void dispatch_register_generic( dispatch_table &t, const cpu_caps & )
+{
+  t.e[0][0] = raw_caware_wrapper<dispatch_type<1, false>::type>::entry( "caware" );
+  t.e[1][0] = raw_caware_wrapper<dispatch_type<2, false>::type>::entry( "caware" );
+  t.e[2][0] = raw_caware_wrapper<dispatch_type<4, false>::type>::entry( "caware" );
+  t.e[3][0] = raw_caware_wrapper<dispatch_type<8, false>::type>::entry( "caware" );
+  t.e[4][0] = raw_caware_wrapper<dispatch_type<16, false>::type>::entry( "caware" );
+  {
+    using T = dispatch_type<8, true>::type;
+    t.e[3][1] = raw_kernel_wrapper<T, caware_kernel<T, true, transpose_kernels::Naive4x4Kernel<T, true> > >::entry( "Naive4x4" );
+  }
+  {
+    using T = dispatch_type<16, true>::type;
+    t.e[4][1] = raw_kernel_wrapper<T, caware_kernel<T, true, transpose_kernels::Naive4x4Kernel<T, true> > >::entry( "Naive4x4" );
+  }
+  for ( unsigned k = 0; k < 5; ++k )
+    t.valid[k][0] = true;
+  t.valid[3][1] = t.valid[4][1] = true;
+}
+#endif
+
+#if !defined(TRANSPOSE_USE_LIB) || defined(TRANSPOSE_ISA_SSE2)
+inline void dispatch_register_sse( dispatch_table &t, const cpu_caps &caps )
+{
+#ifdef HAVE_SSE2_8x8x16_KERNEL
+  if ( caps.sse2 ) {
+    using T = dispatch_type<2, false>::type;
+    t.e[1][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::SSE2_8x8x16Kernel<T, false> > >::entry( "SSE2_8x8x16" );
+  }
+#endif
+#ifdef HAVE_SSE_4X4X32_KERNEL
+  if ( caps.sse ) {
+    using T = dispatch_type<4, false>::type;
+    t.e[2][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::SSE_4x4x32Kernel<T, false> > >::entry( "SSE_4x4x32" );
+  }
+#endif
+#ifdef HAVE_SSE2_4X4X64_KERNEL
+  if ( caps.sse2 ) {
+    using T = dispatch_type<8, false>::type;
+    t.e[3][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::SSE2_4x4x64Kernel<T, false> > >::entry( "SSE2_4x4x64" );
+    using U = dispatch_type<8, true>::type;
+    t.e[3][1] = raw_kernel_wrapper<U, caware_kernel<U, true, transpose_kernels::SSE2_4x4x64Kernel<U, true> > >::entry( "SSE2_4x4x64" );
+  }
+#endif
+#ifdef HAVE_SSE2_4X4X128_KERNEL
+  if ( caps.sse2 ) {
+    using T = dispatch_type<16, false>::type;
+    t.e[4][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::SSE2_4x4x128Kernel<T, false> > >::entry( "SSE2_4x4x128" );
+    t.e[4][1] = raw_kernel_wrapper<T, caware_kernel<T, true, transpose_kernels::SSE2_4x4x128Kernel<T, true> > >::entry( "SSE2_4x4x128" );
+  }
+#endif
+  (void)t;
+  (void)caps;
+}
+#endif
+
+#if !defined(TRANSPOSE_USE_LIB) || defined(TRANSPOSE_ISA_SSE41)
+inline void dispatch_register_sse41( dispatch_table &t, const cpu_caps &caps )
+{
+#ifdef HAVE_SSE41_8x8x8_KERNEL
+#ifdef _MSC_VER
+  // MSVC compiles the SSE4.1 kernel only with /arch:AVX: VEX encoded
+  if ( caps.sse41 && caps.avx ) {
+#else
+  if ( caps.sse41 ) {
+#endif
+    using T = dispatch_type<1, false>::type;
+    t.e[0][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::SSE41_8x8x8Kernel<T, false> > >::entry( "SSE41_8x8x8" );
+  }
+#endif
+  (void)t;
+  (void)caps;
+}
+#endif
+
+#if !defined(TRANSPOSE_USE_LIB) || defined(TRANSPOSE_ISA_NEON)
+// native AArch64 kernels: replace the sse2neon emulated SSE kernels
+inline void dispatch_register_neon( dispatch_table &t, const cpu_caps &caps )
+{
+#ifdef HAVE_NEON_16X16X8_KERNEL
+  if ( caps.neon ) {
+    using T = dispatch_type<1, false>::type;
+    t.e[0][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::NEON_16x16x8Kernel<T, false> > >::entry( "NEON_16x16x8" );
+  }
+#endif
+#ifdef HAVE_NEON_8X8X16_KERNEL
+  if ( caps.neon ) {
+    using T = dispatch_type<2, false>::type;
+    t.e[1][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::NEON_8x8x16Kernel<T, false> > >::entry( "NEON_8x8x16" );
+  }
+#endif
+#ifdef HAVE_NEON_4X4X32_KERNEL
+  if ( caps.neon ) {
+    using T = dispatch_type<4, false>::type;
+    t.e[2][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::NEON_4x4x32Kernel<T, false> > >::entry( "NEON_4x4x32" );
+  }
+#endif
+#ifdef HAVE_NEON_4X4X64_KERNEL
+  if ( caps.neon ) {
+    using T = dispatch_type<8, false>::type;
+    t.e[3][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::NEON_4x4x64Kernel<T, false> > >::entry( "NEON_4x4x64" );
+    using U = dispatch_type<8, true>::type;
+    t.e[3][1] = raw_kernel_wrapper<U, caware_kernel<U, true, transpose_kernels::NEON_4x4x64Kernel<U, true> > >::entry( "NEON_4x4x64" );
+  }
+#endif
+  (void)t;
+  (void)caps;
+}
+#endif
+
+#if !defined(TRANSPOSE_USE_LIB) || defined(TRANSPOSE_ISA_AVX)
+inline void dispatch_register_avx( dispatch_table &t, const cpu_caps &caps )
+{
+#ifdef HAVE_AVX_8X8X32_KERNEL
+  if ( caps.avx ) {
+    using T = dispatch_type<4, false>::type;
+    t.e[2][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::AVX_8x8x32Kernel<T, false> > >::entry( "AVX_8x8x32" );
+  }
+#endif
+#ifdef HAVE_AVX_4X4X64_KERNEL
+  if ( caps.avx ) {
+    using T = dispatch_type<8, false>::type;
+    t.e[3][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::AVX_4x4x64Kernel<T, false> > >::entry( "AVX_4x4x64" );
+    using U = dispatch_type<8, true>::type;
+    t.e[3][1] = raw_kernel_wrapper<U, caware_kernel<U, true, transpose_kernels::AVX_4x4x64Kernel<U, true> > >::entry( "AVX_4x4x64" );
+  }
+#endif
+#ifdef HAVE_AVX_4X4X128_KERNEL
+  if ( caps.avx ) {
+    using T = dispatch_type<16, false>::type;
+    t.e[4][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::AVX_4x4x128Kernel<T, false> > >::entry( "AVX_4x4x128" );
+    t.e[4][1] = raw_kernel_wrapper<T, caware_kernel<T, true, transpose_kernels::AVX_4x4x128Kernel<T, true> > >::entry( "AVX_4x4x128" );
+  }
+#endif
+  (void)t;
+  (void)caps;
+}
+#endif
+
+
+#if !defined(TRANSPOSE_USE_LIB) || defined(TRANSPOSE_ISA_AVX2)
+inline void dispatch_register_avx2( dispatch_table &t, const cpu_caps &caps )
+{
+#ifdef HAVE_AVX2_16X16X8_KERNEL
+  if ( caps.avx2 ) {
+    using T = dispatch_type<1, false>::type;
+    t.e[0][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::AVX2_16x16x8Kernel<T, false> > >::entry( "AVX2_16x16x8" );
+  }
+#endif
+#ifdef HAVE_AVX2_16X16X16_KERNEL
+  if ( caps.avx2 ) {
+    using T = dispatch_type<2, false>::type;
+    t.e[1][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::AVX2_16x16x16Kernel<T, false> > >::entry( "AVX2_16x16x16" );
+  }
+#endif
+  (void)t;
+  (void)caps;
+}
+#endif
+
+#if !defined(TRANSPOSE_USE_LIB) || defined(TRANSPOSE_ISA_AVX512)
+inline void dispatch_register_avx512( dispatch_table &t, const cpu_caps &caps )
+{
+#ifdef HAVE_AVX512_16X16X32_KERNEL
+  if ( caps.avx512f ) {
+    using T = dispatch_type<4, false>::type;
+    t.e[2][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::AVX512_16x16x32Kernel<T, false> > >::entry( "AVX512_16x16x32" );
+  }
+#endif
+#ifdef HAVE_AVX512_8X8X64_KERNEL
+  if ( caps.avx512f ) {
+    using T = dispatch_type<8, false>::type;
+    t.e[3][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::AVX512_8x8x64Kernel<T, false> > >::entry( "AVX512_8x8x64" );
+    using U = dispatch_type<8, true>::type;
+    t.e[3][1] = raw_kernel_wrapper<U, caware_kernel<U, true, transpose_kernels::AVX512_8x8x64Kernel<U, true> > >::entry( "AVX512_8x8x64" );
+  }
+#endif
+#ifdef HAVE_AVX512_4X4X128_KERNEL
+  if ( caps.avx512f ) {
+    using T = dispatch_type<16, false>::type;
+    t.e[4][0] = raw_kernel_wrapper<T, caware_kernel<T, false, transpose_kernels::AVX512_4x4x128Kernel<T, false> > >::entry( "AVX512_4x4x128" );
+    t.e[4][1] = raw_kernel_wrapper<T, caware_kernel<T, true, transpose_kernels::AVX512_4x4x128Kernel<T, true> > >::entry( "AVX512_4x4x128" );
+  }
+#endif
+  (void)t;
+  (void)caps;
+}
+#endif
+
+
+inline unsigned dispatch_index( unsigned elemSize )
+{
+  switch ( elemSize ) {
+    case  1:  return 0;
+    case  2:  return 1;
+    case  4:  return 2;
+    case  8:  return 3;
+    case 16:  return 4;
+    default:  return 5;
+  }
+}
+
+
+#ifdef TRANSPOSE_USE_LIB
+
+// returns the selected kernel for the element size in bytes and conjugation
+//   returns nullptr for unsupported element size / conjugation
+//   implemented in the library, which builds the table from all compiled instruction sets
+const dispatch_entry * dispatch_select( unsigned elemSize, bool conjugate );
+
+#else
+
+inline dispatch_table build_dispatch_table( const cpu_caps & caps )
+{
+  dispatch_table t;
+  for ( unsigned k = 0; k < 5; ++k )
+    t.valid[k][0] = t.valid[k][1] = false;
+  dispatch_register_generic( t, caps );
+  dispatch_register_sse( t, caps );
+  dispatch_register_sse41( t, caps );
+  dispatch_register_neon( t, caps );
+  dispatch_register_avx( t, caps );
+  dispatch_register_avx2( t, caps );
+  dispatch_register_avx512( t, caps );
+  return t;
+}
+
+// returns the selected kernel for the element size in bytes and conjugation
+//   returns nullptr for unsupported element size / conjugation
+//   the CPU is detected and the table is built only once, at first call
+inline const dispatch_entry * dispatch_select( unsigned elemSize, bool conjugate )
+{
+  static const dispatch_table tbl = build_dispatch_table( detected_cpu_caps() );
+  const unsigned k = dispatch_index( elemSize );
+  const unsigned cj = conjugate ? 1U : 0U;
+  return ( k < 5 && tbl.valid[k][cj] ) ? &tbl.e[k][cj] : nullptr;
+}
+
+#endif
+
+
+// transpose with best kernel for the executing CPU
+//   with streaming stores for outputs from streaming_store_threshold() bytes
+//   blocked for L1 / L2 / TLB for outputs beyond blocking_threshold() bytes
+//   CONJUGATE is only supported for std::complex<float or double>
+//   types without matching kernel fall back to the non-SIMD implementations
+template <class T, bool CONJUGATE = false>
+HEDLEY_NO_THROW
+static void transpose(
+  const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+  const mat_info &out, NO_ESCAPE T * RESTRICT pout )
+{
+  static_assert( !CONJUGATE
+    || std::is_same<T, std::complex<float> >::value
+    || std::is_same<T, std::complex<double> >::value
+    , "CONJUGATE is only supported by transpose for std::complex<float or double>" );
+
+  static const dispatch_entry * const e = std::is_trivially_copyable<T>::value
+    ? dispatch_select( sizeof(T), CONJUGATE ) : nullptr;
+  if ( e ) {
+    const bool use_in = ( in.nRows < in.nCols );
+    const std::size_t out_bytes = std::size_t(out.nRows) * out.rowSize * sizeof(T);
+    const bool aligned = e->aa_in && e->aa_possible( in, pin, out, pout );
+    // streamed output lines don't stay in cache: input order is faster, independent of the shape
+    if ( aligned && e->nt_in && out_bytes >= streaming_store_threshold() )
+      e->nt_in( in, pin, out, pout );
+    else if ( e->bk_in && out_bytes > blocking_threshold() )
+      ( use_in ? e->bk_in : e->bk_out )( in, pin, out, pout );
+    else if ( aligned )
+      ( use_in ? e->aa_in : e->aa_out )( in, pin, out, pout );
+    else if ( e->pa_in )
+      ( use_in ? e->pa_in : e->pa_out )( in, pin, out, pout );
+    else
+      ( use_in ? e->uu_in : e->uu_out )( in, pin, out, pout );
+  }
+  else if constexpr ( CONJUGATE )
+    naive_meta<T, T, CONJUGATE>( in, pin, out, pout );
+  else
+    caware_meta<T, T>( in, pin, out, pout );
+}
+
+}
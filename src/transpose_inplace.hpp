@@ -0,0 +1,247 @@
+#pragma once
+
+// in-place transpose of square matrices: no 2nd matrix in memory - and no copy back.
+//   the pairs of tiles (i,j) / (j,i) above and below the diagonal get swapped with the dispatched SIMD kernel:
+//   tile (i,j) is transposed into a small buffer, tile (j,i) directly onto (i,j) - and the buffer copied to (j,i).
+//   diagonal tiles go through the buffer, too. the pairs of a tile row are processed in chunks,
+//   for fewer calls into the type erased kernel. rows / columns beyond the full tiles get swapped element-wise
+//
+// in-place transpose of rectangular matrices without padding: with the decomposition of Catanzaro et al.
+//   "A Decomposition for In-place Matrix Transposition" into permutations inside of rows and inside of columns,
+//   which need only scratch for some rows / columns. columns get permuted in blocks: transposed with the
+//   dispatched kernel into the scratch, permuted there inside of contiguous rows - and transposed back
+
+#include "transpose_defs.hpp"
+#include "transpose_dispatch.hpp"
+#include "transpose_cpu.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <complex>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+
+namespace transpose
+{
+
+// #tile pairs, which get swapped per step - and the size of the buffer in tiles
+static constexpr unsigned INPLACE_CHUNK = 16;
+// max. bytes of a kernel tile: 16 x 16 x 32 bit
+static constexpr unsigned INPLACE_TILE_BYTES = 1024;
+
+
+template <class T, bool CONJUGATE>
+ALWAYS_INLINE T inplace_conj( const T &v )
+{
+  if constexpr ( CONJUGATE )
+    return std::conj( v );
+  else
+    return v;
+}
+
+
+// the element-wise part of the in-place transpose: the elements (r, c) with c >= nFull, r <= c - and their mirrors
+template <class T, bool CONJUGATE>
+HEDLEY_NO_THROW
+static void inplace_square_tails( const unsigned n, T * p, const unsigned rowSize, const unsigned nFull )
+{
+  for ( unsigned c = nFull; c < n; ++c ) {
+    for ( unsigned r = 0; r < c; ++r ) {
+      const T v = p[std::size_t(r) * rowSize + c];
+      p[std::size_t(r) * rowSize + c] = inplace_conj<T, CONJUGATE>( p[std::size_t(c) * rowSize + r] );
+      p[std::size_t(c) * rowSize + r] = inplace_conj<T, CONJUGATE>( v );
+    }
+    if constexpr ( CONJUGATE )
+      p[std::size_t(c) * rowSize + c] = std::conj( p[std::size_t(c) * rowSize + c] );
+  }
+}
+
+
+// one step of the in-place transpose with the tiles functions of e: tile row i,
+//   either the diagonal tile (j0 == i, cnt == 1) or the cnt tile pairs (i, j0 ..) / (j0 .., i) with j0 > i.
+//   different steps touch different tiles: they can run in parallel
+template <class T>
+HEDLEY_NO_THROW
+static void inplace_square_step(
+  const dispatch_entry &e, const bool aligned, T * p, const unsigned rowSize,
+  const unsigned i, const unsigned j0, const unsigned cnt )
+{
+  const unsigned K = e.kernel_sz;
+  const raw_tiles_fn tiles = aligned ? e.tiles_aa_out : e.tiles_uu_out;
+  // buffer of cnt * K rows with K columns - aligned for the aligned kernel
+  alignas(64) unsigned char raw[ INPLACE_CHUNK * INPLACE_TILE_BYTES ];
+  T * buf = reinterpret_cast<T *>( raw );
+
+  T * pA = &p[std::size_t(i * K) * rowSize + j0 * K];   // tiles (i, j0 ..)
+  T * pB = &p[std::size_t(j0 * K) * rowSize + i * K];   // tiles (j0 .., i)
+  tiles( pA, buf, cnt, 1, rowSize, K );
+  if ( j0 != i )
+    tiles( pB, pA, 1, cnt, rowSize, rowSize );
+  for ( unsigned r = 0; r < cnt * K; ++r )
+    std::memcpy( &pB[std::size_t(r) * rowSize], &buf[r * K], K * sizeof(T) );
+}
+
+
+// #steps of tile row i of nT tile rows: diagonal and chunks of pairs
+HEDLEY_CONST
+inline unsigned inplace_square_row_steps( const unsigned i, const unsigned nT )
+{
+  return 1 + ( nT - 1 - i + INPLACE_CHUNK - 1 ) / INPLACE_CHUNK;
+}
+
+
+// kernel and alignment for the in-place transpose: nullptr for the element-wise transpose
+template <class T, bool CONJUGATE>
+static const dispatch_entry * inplace_square_kernel( const T * p, const unsigned rowSize, bool &aligned )
+{
+  static const dispatch_entry * const e = std::is_trivially_copyable<T>::value
+    ? dispatch_select( sizeof(T), CONJUGATE ) : nullptr;
+  if ( !e || !e->tiles_uu_out || e->kernel_sz * e->kernel_sz * sizeof(T) > INPLACE_TILE_BYTES )
+    return nullptr;
+  const std::uintptr_t A = e->kernel_sz * sizeof(T);
+  aligned = e->tiles_aa_out && !( rowSize % e->kernel_sz ) && !( reinterpret_cast<std::uintptr_t>(p) % A );
+  return e;
+}
+
+
+// in-place transpose of the square n x n matrix at p with row size rowSize >= n
+//   CONJUGATE is only supported for std::complex<float or double>
+template <class T, bool CONJUGATE = false>
+HEDLEY_NO_THROW
+static void transpose_inplace( const unsigned n, NO_ESCAPE T * p, const unsigned rowSize )
+{
+  static_assert( !CONJUGATE
+    || std::is_same<T, std::complex<float> >::value
+    || std::is_same<T, std::complex<double> >::value
+    , "CONJUGATE is only supported by transpose_inplace for std::complex<float or double>" );
+
+  bool aligned = false;
+  const dispatch_entry * e = inplace_square_kernel<T, CONJUGATE>( p, rowSize, aligned );
+  if ( !e ) {
+    inplace_square_tails<T, CONJUGATE>( n, p, rowSize, 0 );
+    return;
+  }
+  const unsigned nT = n / e->kernel_sz;
+  for ( unsigned i = 0; i < nT; ++i ) {
+    inplace_square_step<T>( *e, aligned, p, rowSize, i, i, 1 );
+    for ( unsigned j0 = i + 1; j0 < nT; j0 += INPLACE_CHUNK )
+      inplace_square_step<T>( *e, aligned, p, rowSize, i, j0, ( nT - j0 < INPLACE_CHUNK ) ? nT - j0 : INPLACE_CHUNK );
+  }
+  inplace_square_tails<T, CONJUGATE>( n, p, rowSize, nT * e->kernel_sz );
+}
+
+
+
+// column permutation of the m x n matrix at p in blocks of w columns through the scratch t of w x m elements
+//   and row of m elements: column j gets col[i] = col[ ( perm[i] + rot( j ) ) % m ] - or col[ ( i + rot( j ) ) % m ]
+//   without perm, which is just a rotation. the 1st transpose conjugates with CONJUGATE
+template <class T, bool CONJUGATE, class ROT>
+HEDLEY_NO_THROW
+static void inplace_rect_columns(
+  const unsigned m, const unsigned n, T * p, const unsigned w,
+  T * RESTRICT t, T * RESTRICT row, const unsigned * perm, ROT &&rot )
+{
+  for ( unsigned j0 = 0; j0 < n; j0 += w ) {
+    const unsigned nC = ( n - j0 < w ) ? n - j0 : w;
+    transpose<T, CONJUGATE>( mat_info { m, nC, n }, &p[j0], mat_info { nC, m, m }, t );
+    for ( unsigned jj = 0; jj < nC; ++jj ) {
+      T * col = &t[std::size_t(jj) * m];
+      const unsigned r = rot( j0 + jj );
+      if ( perm ) {
+        const T * rcol = col + r;   // col[ perm[i] + r ] for perm[i] < m - r, else col[ perm[i] + r - m ]
+        const unsigned lim = m - r;
+        for ( unsigned i = 0; i < m; ++i )
+          row[i] = ( perm[i] < lim ) ? rcol[ perm[i] ] : col[ perm[i] - lim ];
+      }
+      else if ( r ) {
+        std::memcpy( row, col + r, std::size_t(m - r) * sizeof(T) );
+        std::memcpy( row + ( m - r ), col, std::size_t(r) * sizeof(T) );
+      }
+      else
+        continue;
+      std::memcpy( col, row, std::size_t(m) * sizeof(T) );
+    }
+    transpose<T, false>( mat_info { nC, m, m }, t, mat_info { m, nC, n }, &p[j0] );
+  }
+}
+
+
+// in-place transpose of the nRows x nCols matrix at p with row size nCols into the nCols x nRows matrix
+//   with row size nRows. scratchBytes limits the scratch, which gets allocated - but at least
+//   nRows + max( nRows, nCols ) elements and nRows unsigned are necessary. 0 for half of the L2 cache.
+//   returns false, when the allocation of the scratch failed - then the matrix is untouched.
+//   CONJUGATE is only supported for std::complex<float or double>
+template <class T, bool CONJUGATE = false>
+HEDLEY_NO_THROW
+static bool transpose_inplace_rect(
+  const unsigned nRows, const unsigned nCols, NO_ESCAPE T * p,
+  std::size_t scratchBytes = 0 )
+{
+  static_assert( std::is_trivially_copyable<T>::value, "transpose_inplace_rect requires trivially copyable types" );
+  if ( nRows == nCols ) {
+    transpose_inplace<T, CONJUGATE>( nRows, p, nCols );
+    return true;
+  }
+  if ( !nRows || !nCols )
+    return true;
+
+  const unsigned m = nRows, n = nCols;
+  const unsigned mn = ( m > n ) ? m : n;
+  if ( !scratchBytes )
+    scratchBytes = detected_cpu_caches().l2 / 2;
+  // block of w columns, transposed into the scratch: in multiples of the kernel sizes - without tails
+  const std::size_t budget = scratchBytes / sizeof(T);
+  std::size_t w = ( budget > std::size_t(mn) + m ) ? ( budget - mn ) / m : 1;
+  w = ( w > n ) ? n : ( w >= 16 ) ? ( w & ~std::size_t(15) ) : w;
+  std::size_t space = ( w * m + mn ) * sizeof(T) + 64;
+  std::unique_ptr<unsigned char[]> raw( new (std::nothrow) unsigned char[space] );
+  std::unique_ptr<unsigned[]> perm( new (std::nothrow) unsigned[m] );
+  if ( !raw || !perm )
+    return false;
+  void * vp = raw.get();
+  T * t = static_cast<T *>( std::align( 64, ( w * m + mn ) * sizeof(T), vp, space ) );
+  T * row = t + w * m;
+
+  unsigned c = m, r = n;
+  while ( r ) { const unsigned q = c % r; c = r; r = q; }  // gcd
+  const unsigned a = m / c, b = n / c;
+
+  // 1st: rotate column j by j / b - only necessary for c > 1
+  if ( c > 1 )
+    inplace_rect_columns<T, false>( m, n, p, unsigned(w), t, row, nullptr,
+      [m, b] ( unsigned j ) { return ( j / b ) % m; } );
+
+  // 2nd: scatter inside of each row: row[ d_i(j) ] = p[i][j]
+  //   with d_i(j) = ( ( i + j / b ) % m + j * m ) % n
+  const unsigned m_mod_n = m % n;
+  for ( unsigned i = 0; i < m; ++i ) {
+    T * prow = &p[std::size_t(i) * n];
+    unsigned jm = 0;            // j * m % n
+    unsigned k = i, rot = i % n;   // ( i + q ) % m and rot = k % n
+    for ( unsigned j0 = 0; j0 < n; j0 += b ) {
+      for ( unsigned j = j0; j < j0 + b; ++j ) {
+        const unsigned d = ( rot + jm < n ) ? rot + jm : rot + jm - n;
+        row[d] = prow[j];
+        jm = ( jm + m_mod_n < n ) ? jm + m_mod_n : jm + m_mod_n - n;
+      }
+      if ( ++k == m )
+        k = rot = 0;
+      else if ( ++rot == n )
+        rot = 0;
+    }
+    std::memcpy( prow, row, std::size_t(n) * sizeof(T) );
+  }
+
+  // 3rd: gather inside of each column: p[i][j] = p[ s_j(i) ][j]
+  //   with s_j(i) = ( j + i * n - i / a ) % m = ( j % m + perm[i] ) % m
+  for ( unsigned i = 0; i < m; ++i )
+    perm[i] = unsigned( ( std::size_t(i) * n + m - ( i / a ) ) % m );
+  inplace_rect_columns<T, CONJUGATE>( m, n, p, unsigned(w), t, row, perm.get(),
+    [m] ( unsigned j ) { return j % m; } );
+  return true;
+}
+
+}
@@ -0,0 +1,21 @@
+
+// compiled with AVX flags: AVX_8x8x32Kernel, AVX_4x4x64Kernel and AVX_4x4x128Kernel
+
+// selects the registration function of this unit in transpose_dispatch.hpp
+#define TRANSPOSE_ISA_AVX 1
+
+#include "transpose_dispatch.hpp"
+#include "transpose_lib_isa.hpp"
+
+namespace transpose
+{
+namespace isa
+{
+
+void register_avx( dispatch_table &t, const cpu_caps &caps )
+{
+  dispatch_register_avx( t, caps );
+}
+
+}
+}
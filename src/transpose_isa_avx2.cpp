@@ -0,0 +1,21 @@
+
+// compiled with AVX2 flags: AVX2_16x16x8Kernel and AVX2_16x16x16Kernel
+
+// selects the registration function of this unit in transpose_dispatch.hpp
+#define TRANSPOSE_ISA_AVX2 1
+
+#include "transpose_dispatch.hpp"
+#include "transpose_lib_isa.hpp"
+
+namespace transpose
+{
+namespace isa
+{
+
+void register_avx2( dispatch_table &t, const cpu_caps &caps )
+{
+  dispatch_register_avx2( t, caps );
+}
+
+}
+}
@@ -0,0 +1,21 @@
+
+// compiled with AVX-512F flags: AVX512_16x16x32Kernel, AVX512_8x8x64Kernel and AVX512_4x4x128Kernel
+
+// selects the registration function of this unit in transpose_dispatch.hpp
+#define TRANSPOSE_ISA_AVX512 1
+
+#include "transpose_dispatch.hpp"
+#include "transpose_lib_isa.hpp"
+
+namespace transpose
+{
+namespace isa
+{
+
+void register_avx512( dispatch_table &t, const cpu_caps &caps )
+{
+  dispatch_register_avx512( t, caps );
+}
+
+}
+}
@@ -0,0 +1,22 @@
+
+// compiled for AArch64 without extra flags: NEON_16x16x8Kernel, NEON_8x8x16Kernel,
+//   NEON_4x4x32Kernel and NEON_4x4x64Kernel. empty on other platforms
+
+// selects the registration function of this unit in transpose_dispatch.hpp
+#define TRANSPOSE_ISA_NEON 1
+
+#include "transpose_dispatch.hpp"
+#include "transpose_lib_isa.hpp"
+
+namespace transpose
+{
+namespace isa
+{
+
+void register_neon( dispatch_table &t, const cpu_caps &caps )
+{
+  dispatch_register_neon( t, caps );
+}
+
+}
+}
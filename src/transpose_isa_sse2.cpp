@@ -0,0 +1,21 @@
+
+// compiled with SSE2 flags: SSE_4x4x32Kernel, SSE2_8x8x16Kernel, SSE2_4x4x64Kernel and SSE2_4x4x128Kernel
+
+// selects the registration function of this unit in transpose_dispatch.hpp
+#define TRANSPOSE_ISA_SSE2 1
+
+#include "transpose_dispatch.hpp"
+#include "transpose_lib_isa.hpp"
+
+namespace transpose
+{
+namespace isa
+{
+
+void register_sse2( dispatch_table &t, const cpu_caps &caps )
+{
+  dispatch_register_sse( t, caps );
+}
+
+}
+}
@@ -0,0 +1,21 @@
+
+// compiled with SSE4.1 flags: SSE41_8x8x8Kernel
+
+// selects the registration function of this unit in transpose_dispatch.hpp
+#define TRANSPOSE_ISA_SSE41 1
+
+#include "transpose_dispatch.hpp"
+#include "transpose_lib_isa.hpp"
+
+namespace transpose
+{
+namespace isa
+{
+
+void register_sse41( dispatch_table &t, const cpu_caps &caps )
+{
+  dispatch_register_sse41( t, caps );
+}
+
+}
+}
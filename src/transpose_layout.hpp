@@ -0,0 +1,301 @@
+#pragma once
+
+// reorders of activation tensors between the layouts
+//   NCHW:    [N][C][H][W]         channel first: one plane of H * W pixels per channel
+//   NHWC:    [N][H][W][C]         channel last: the C channels of each pixel are contiguous
+//   NCHWc16: [N][C/16][H][W][16]  channel blocked: blocks of 16 channels - the last block padded with zeros
+// NCHW <-> NHWC and NCHW <-> NCHWc16 are transposes of C x H * W matrices per image - or of 16 x H * W per block.
+//   these get transposed with the SIMD kernels - but channel counts below the kernel size would leave only tails:
+//   3, 4 and 8 channels get fixed size loops, which the compiler vectorizes (with -O3) across the pixels.
+// NHWC <-> NCHWc16 are copies of 16 channels per pixel - with fixed size loops for 3, 4 and 8 channels
+
+#include "transpose_defs.hpp"
+#include "transpose_dispatch.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+
+namespace transpose
+{
+
+enum class tensor_layout
+{
+  NCHW,
+  NHWC,
+  NCHWc16
+};
+
+// channels per block of tensor_layout::NCHWc16
+static constexpr unsigned LAYOUT_BLOCK = 16;
+
+
+// calls fn( std::integral_constant<unsigned, nC>() ) for the channel counts with fixed size loops: 3, 4 and 8.
+//   returns false for other channel counts
+template <class FN>
+static bool with_fixed_channels( const unsigned nC, FN &&fn )
+{
+  switch ( nC ) {
+  case 3: fn( std::integral_constant<unsigned, 3>() ); return true;
+  case 4: fn( std::integral_constant<unsigned, 4>() ); return true;
+  case 8: fn( std::integral_constant<unsigned, 8>() ); return true;
+  default: return false;
+  }
+}
+
+// C planes of HW pixels -> HW pixels with stride S: the channels [C, S) get zeroed
+template <class T, unsigned C, unsigned S>
+HEDLEY_NO_THROW
+static void planes_to_pixels_fixed( NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout, const std::size_t HW )
+{
+  for ( std::size_t p = 0; p < HW; ++p ) {
+    for ( unsigned c = 0; c < C; ++c )
+      pout[p * S + c] = pin[c * HW + p];
+    for ( unsigned c = C; c < S; ++c )
+      pout[p * S + c] = T();
+  }
+}
+
+// HW pixels with stride S -> C planes of HW pixels
+template <class T, unsigned C, unsigned S>
+HEDLEY_NO_THROW
+static void pixels_to_planes_fixed( NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout, const std::size_t HW )
+{
+  for ( std::size_t p = 0; p < HW; ++p )
+    for ( unsigned c = 0; c < C; ++c )
+      pout[c * HW + p] = pin[p * S + c];
+}
+
+// C channels of HW pixels with stride SI -> HW pixels with stride SO: the channels [C, SO) get zeroed
+template <class T, unsigned C, unsigned SI, unsigned SO>
+HEDLEY_NO_THROW
+static void pixels_copy_fixed( NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout, const std::size_t HW )
+{
+  for ( std::size_t p = 0; p < HW; ++p ) {
+    for ( unsigned c = 0; c < C; ++c )
+      pout[p * SO + c] = pin[p * SI + c];
+    for ( unsigned c = C; c < SO; ++c )
+      pout[p * SO + c] = T();
+  }
+}
+
+
+// nC planes of HW pixels with plane stride inStride -> HW pixels with pixel stride outStride:
+//   the channels [nC, outStride) get zeroed. contiguous planes with fixed channel counts below the kernel size
+//   get the fixed size loops - for pixel strides nC (NHWC) and LAYOUT_BLOCK (NCHWc16)
+template <class T>
+HEDLEY_NO_THROW
+static void planes_to_pixels(
+  const unsigned nC, const unsigned HW,
+  NO_ESCAPE const T * RESTRICT pin, const unsigned inStride,
+  NO_ESCAPE T * RESTRICT pout, const unsigned outStride )
+{
+  static const dispatch_entry * const e = std::is_trivially_copyable<T>::value
+    ? dispatch_select( sizeof(T), false ) : nullptr;
+  if ( inStride == HW && ( outStride == nC || outStride == LAYOUT_BLOCK ) && ( !e || nC < e->kernel_sz )
+    && with_fixed_channels( nC, [&] ( auto c ) {
+      constexpr unsigned C = decltype(c)::value;
+      if ( outStride == C )
+        planes_to_pixels_fixed<T, C, C>( pin, pout, HW );
+      else
+        planes_to_pixels_fixed<T, C, LAYOUT_BLOCK>( pin, pout, HW );
+    } ) )
+    return;
+
+  transpose<T>( mat_info { nC, HW, inStride }, pin, mat_info { HW, nC, outStride }, pout );
+  for ( std::size_t p = 0; p < HW; ++p )
+    for ( unsigned c = nC; c < outStride; ++c )
+      pout[p * outStride + c] = T();
+}
+
+// HW pixels with pixel stride inStride -> nC planes of HW pixels with plane stride outStride
+template <class T>
+HEDLEY_NO_THROW
+static void pixels_to_planes(
+  const unsigned nC, const unsigned HW,
+  NO_ESCAPE const T * RESTRICT pin, const unsigned inStride,
+  NO_ESCAPE T * RESTRICT pout, const unsigned outStride )
+{
+  static const dispatch_entry * const e = std::is_trivially_copyable<T>::value
+    ? dispatch_select( sizeof(T), false ) : nullptr;
+  if ( outStride == HW && ( inStride == nC || inStride == LAYOUT_BLOCK ) && ( !e || nC < e->kernel_sz )
+    && with_fixed_channels( nC, [&] ( auto c ) {
+      constexpr unsigned C = decltype(c)::value;
+      if ( inStride == C )
+        pixels_to_planes_fixed<T, C, C>( pin, pout, HW );
+      else
+        pixels_to_planes_fixed<T, C, LAYOUT_BLOCK>( pin, pout, HW );
+    } ) )
+    return;
+
+  transpose<T>( mat_info { HW, nC, inStride }, pin, mat_info { nC, HW, outStride }, pout );
+}
+
+
+// the reorders for N images of C channels with H x W pixels:
+//   return false, when H * W doesn't fit into an unsigned
+
+template <class T>
+HEDLEY_NO_THROW
+static bool nchw_to_nhwc(
+  const unsigned N, const unsigned C, const unsigned H, const unsigned W,
+  NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout )
+{
+  const std::size_t HW = std::size_t(H) * W, img = HW * C;
+  if ( HW > 0xFFFFFFFFU )
+    return false;
+  for ( unsigned n = 0; n < N; ++n )
+    planes_to_pixels<T>( C, unsigned(HW), &pin[n * img], unsigned(HW), &pout[n * img], C );
+  return true;
+}
+
+template <class T>
+HEDLEY_NO_THROW
+static bool nhwc_to_nchw(
+  const unsigned N, const unsigned C, const unsigned H, const unsigned W,
+  NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout )
+{
+  const std::size_t HW = std::size_t(H) * W, img = HW * C;
+  if ( HW > 0xFFFFFFFFU )
+    return false;
+  for ( unsigned n = 0; n < N; ++n )
+    pixels_to_planes<T>( C, unsigned(HW), &pin[n * img], C, &pout[n * img], unsigned(HW) );
+  return true;
+}
+
+
+// #elements of an image in NCHWc16
+inline std::size_t nchwc16_image_size( const unsigned C, const unsigned H, const unsigned W )
+{
+  return std::size_t( ( C + LAYOUT_BLOCK - 1 ) / LAYOUT_BLOCK ) * LAYOUT_BLOCK * H * W;
+}
+
+template <class T>
+HEDLEY_NO_THROW
+static bool nchw_to_nchwc16(
+  const unsigned N, const unsigned C, const unsigned H, const unsigned W,
+  NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout )
+{
+  const std::size_t HW = std::size_t(H) * W, img = HW * C, bimg = nchwc16_image_size( C, H, W );
+  if ( HW > 0xFFFFFFFFU )
+    return false;
+  for ( unsigned n = 0; n < N; ++n ) {
+    for ( unsigned c0 = 0; c0 < C; c0 += LAYOUT_BLOCK ) {
+      const unsigned nC = ( C - c0 < LAYOUT_BLOCK ) ? C - c0 : LAYOUT_BLOCK;
+      T * out = &pout[n * bimg + std::size_t(c0) * HW];
+      planes_to_pixels<T>( nC, unsigned(HW), &pin[n * img + std::size_t(c0) * HW], unsigned(HW), out, LAYOUT_BLOCK );
+    }
+  }
+  return true;
+}
+
+template <class T>
+HEDLEY_NO_THROW
+static bool nchwc16_to_nchw(
+  const unsigned N, const unsigned C, const unsigned H, const unsigned W,
+  NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout )
+{
+  const std::size_t HW = std::size_t(H) * W, img = HW * C, bimg = nchwc16_image_size( C, H, W );
+  if ( HW > 0xFFFFFFFFU )
+    return false;
+  for ( unsigned n = 0; n < N; ++n ) {
+    for ( unsigned c0 = 0; c0 < C; c0 += LAYOUT_BLOCK ) {
+      const unsigned nC = ( C - c0 < LAYOUT_BLOCK ) ? C - c0 : LAYOUT_BLOCK;
+      pixels_to_planes<T>( nC, unsigned(HW), &pin[n * bimg + std::size_t(c0) * HW], LAYOUT_BLOCK,
+        &pout[n * img + std::size_t(c0) * HW], unsigned(HW) );
+    }
+  }
+  return true;
+}
+
+template <class T>
+HEDLEY_NO_THROW
+static bool nhwc_to_nchwc16(
+  const unsigned N, const unsigned C, const unsigned H, const unsigned W,
+  NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout )
+{
+  const std::size_t HW = std::size_t(H) * W, img = HW * C, bimg = nchwc16_image_size( C, H, W );
+  for ( unsigned n = 0; n < N; ++n ) {
+    // single block with a fixed channel count
+    if ( with_fixed_channels( C, [&] ( auto c ) {
+        pixels_copy_fixed<T, decltype(c)::value, decltype(c)::value, LAYOUT_BLOCK>( &pin[n * img], &pout[n * bimg], HW );
+      } ) )
+      continue;
+    for ( unsigned c0 = 0; c0 < C; c0 += LAYOUT_BLOCK ) {
+      const T * in = &pin[n * img + c0];
+      T * out = &pout[n * bimg + std::size_t(c0) * HW];
+      if ( C - c0 >= LAYOUT_BLOCK ) {
+        for ( std::size_t p = 0; p < HW; ++p )
+          std::memcpy( &out[p * LAYOUT_BLOCK], &in[p * C], LAYOUT_BLOCK * sizeof(T) );
+        continue;
+      }
+      for ( std::size_t p = 0; p < HW; ++p ) {
+        std::memcpy( &out[p * LAYOUT_BLOCK], &in[p * C], ( C - c0 ) * sizeof(T) );
+        for ( unsigned c = C - c0; c < LAYOUT_BLOCK; ++c )
+          out[p * LAYOUT_BLOCK + c] = T();
+      }
+    }
+  }
+  return true;
+}
+
+template <class T>
+HEDLEY_NO_THROW
+static bool nchwc16_to_nhwc(
+  const unsigned N, const unsigned C, const unsigned H, const unsigned W,
+  NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout )
+{
+  const std::size_t HW = std::size_t(H) * W, img = HW * C, bimg = nchwc16_image_size( C, H, W );
+  for ( unsigned n = 0; n < N; ++n ) {
+    if ( with_fixed_channels( C, [&] ( auto c ) {
+        pixels_copy_fixed<T, decltype(c)::value, LAYOUT_BLOCK, decltype(c)::value>( &pin[n * bimg], &pout[n * img], HW );
+      } ) )
+      continue;
+    for ( unsigned c0 = 0; c0 < C; c0 += LAYOUT_BLOCK ) {
+      const T * in = &pin[n * bimg + std::size_t(c0) * HW];
+      T * out = &pout[n * img + c0];
+      if ( C - c0 >= LAYOUT_BLOCK ) {
+        for ( std::size_t p = 0; p < HW; ++p )
+          std::memcpy( &out[p * C], &in[p * LAYOUT_BLOCK], LAYOUT_BLOCK * sizeof(T) );
+      }
+      else {
+        for ( std::size_t p = 0; p < HW; ++p )
+          std::memcpy( &out[p * C], &in[p * LAYOUT_BLOCK], ( C - c0 ) * sizeof(T) );
+      }
+    }
+  }
+  return true;
+}
+
+
+// reorder of N images of C channels with H x W pixels from layout from into layout to:
+//   the output has nchwc16_image_size() elements per image for tensor_layout::NCHWc16 - else C * H * W
+template <class T>
+HEDLEY_NO_THROW
+static bool reorder(
+  const tensor_layout from, const tensor_layout to,
+  const unsigned N, const unsigned C, const unsigned H, const unsigned W,
+  NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout )
+{
+  if ( from == to ) {
+    const std::size_t img = ( from == tensor_layout::NCHWc16 ) ? nchwc16_image_size( C, H, W ) : std::size_t(C) * H * W;
+    std::memcpy( pout, pin, N * img * sizeof(T) );
+    return true;
+  }
+  switch ( from ) {
+  case tensor_layout::NCHW:
+    return ( to == tensor_layout::NHWC )
+      ? nchw_to_nhwc<T>( N, C, H, W, pin, pout ) : nchw_to_nchwc16<T>( N, C, H, W, pin, pout );
+  case tensor_layout::NHWC:
+    return ( to == tensor_layout::NCHW )
+      ? nhwc_to_nchw<T>( N, C, H, W, pin, pout ) : nhwc_to_nchwc16<T>( N, C, H, W, pin, pout );
+  case tensor_layout::NCHWc16:
+    return ( to == tensor_layout::NCHW )
+      ? nchwc16_to_nchw<T>( N, C, H, W, pin, pout ) : nchwc16_to_nhwc<T>( N, C, H, W, pin, pout );
+  }
+  return false;
+}
+
+}
@@ -0,0 +1,47 @@
+
+// compiled for the baseline instruction set of the target:
+//   builds the dispatch table from all the library's translation units
+
+// selects the registration function of this unit in transpose_dispatch.hpp
+#define TRANSPOSE_ISA_GENERIC 1
+
+#include "transpose_dispatch.hpp"
+#include "transpose_lib_isa.hpp"
+
+#ifndef TRANSPOSE_USE_LIB
+#  error the library has to be compiled with TRANSPOSE_USE_LIB
+#endif
+
+namespace transpose
+{
+
+static dispatch_table build_lib_dispatch_table( const cpu_caps & caps )
+{
+  dispatch_table t;
+  for ( unsigned k = 0; k < 5; ++k )
+    t.valid[k][0] = t.valid[k][1] = false;
+  dispatch_register_generic( t, caps );
+  isa::register_sse2( t, caps );
+  isa::register_sse41( t, caps );
+  isa::register_neon( t, caps );
+  isa::register_avx( t, caps );
+  isa::register_avx2( t, caps );
+  isa::register_avx512( t, caps );
+  return t;
+}
+
+block_sizes detected_block_sizes( unsigned elemSize, unsigned kernelSz )
+{
+  const cpu_cache_info &c = detected_cpu_caches();
+  return calc_block_sizes( elemSize, kernelSz, c.l1d, c.l2, c.tlb_entries );
+}
+
+const dispatch_entry * dispatch_select( unsigned elemSize, bool conjugate )
+{
+  static const dispatch_table tbl = build_lib_dispatch_table( detected_cpu_caps() );
+  const unsigned k = dispatch_index( elemSize );
+  const unsigned cj = conjugate ? 1U : 0U;
+  return ( k < 5 && tbl.valid[k][cj] ) ? &tbl.e[k][cj] : nullptr;
+}
+
+}
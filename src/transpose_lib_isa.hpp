@@ -0,0 +1,27 @@
+
+#pragma once
+
+// registration functions of the library's translation units,
+//   each compiled with the compiler flags for it's instruction set
+
+#include "transpose_defs.hpp"
+
+namespace transpose
+{
+
+struct cpu_caps;
+struct dispatch_table;
+
+namespace isa
+{
+
+void register_sse2(  dispatch_table &t, const cpu_caps &caps );
+void register_sse41( dispatch_table &t, const cpu_caps &caps );
+void register_neon(  dispatch_table &t, const cpu_caps &caps );
+void register_avx(   dispatch_table &t, const cpu_caps &caps );
+void register_avx2(  dispatch_table &t, const cpu_caps &caps );
+void register_avx512( dispatch_table &t, const cpu_caps &caps );
+
+}
+
+}
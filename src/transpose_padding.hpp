@@ -0,0 +1,88 @@
+#pragma once
+
+// row sizes for matrices, which are free of cache set conflicts - and their allocation:
+//   with a row size of 2^n bytes, e.g. widths of 1024 or 2048 elements, the rows of a kernel tile
+//   are all mapped to the same cache set - and to the same 4 KB offset, which stalls loads from
+//   "aliasing" earlier stores. then, the columns of the transpose don't fit into the cache's ways.
+//   padding the row size to an odd multiple of the cache line maps consecutive rows to different sets
+//   for every cache level with 2^n sets - while keeping the alignment, which the aligned kernels require.
+//   the kernels stay untouched: producers of the matrices just allocate with the padded row size
+
+#include "transpose_defs.hpp"
+#include "transpose_cpu.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+
+namespace transpose
+{
+
+// recommended row size in elements for nRows x nCols elements of elemSize bytes:
+//   nCols rounded up to a multiple of the alignment unit - the cache line, at least 64 bytes
+//   for the widest kernels - and padded by one more unit, if that multiple is even.
+//   matrices, which fit into the L1 cache, don't suffer from conflicts: there, only the alignment is kept
+HEDLEY_CONST
+inline unsigned calc_padded_row_size(
+  const unsigned elemSize, const unsigned nRows, const unsigned nCols,
+  const unsigned lineSize, const unsigned l1Bytes )
+{
+  const unsigned unit = ( lineSize > 64 ) ? lineSize : 64;
+  if ( !elemSize || unit % elemSize )
+    return nCols;
+  const std::size_t nUnits = ( std::size_t(nCols) * elemSize + unit - 1 ) / unit;
+  std::size_t rowBytes = nUnits * unit;
+  if ( !( nUnits & 1 ) && std::size_t(nRows) * rowBytes > l1Bytes )
+    rowBytes += unit;
+  return unsigned( rowBytes / elemSize );
+}
+
+// recommended row size in elements - for the detected caches
+inline unsigned padded_row_size( const unsigned elemSize, const unsigned nRows, const unsigned nCols )
+{
+  const cpu_cache_info &c = detected_cpu_caches();
+  return calc_padded_row_size( elemSize, nRows, nCols, c.line_size, c.l1d );
+}
+
+template <class T>
+inline unsigned padded_row_size( const unsigned nRows, const unsigned nCols )
+{
+  return padded_row_size( sizeof(T), nRows, nCols );
+}
+
+
+// matrix of nRows x nCols uninitialized elements with padded_row_size(),
+//   aligned to the alignment unit of calc_padded_row_size(). data is nullptr, when the allocation failed.
+//   the transpose gets it's own: padded_matrix<T> out( in.info.nCols, in.info.nRows )
+template <class T>
+struct padded_matrix
+{
+  padded_matrix( const unsigned nRows, const unsigned nCols )
+    : info { nRows, nCols, padded_row_size<T>( nRows, nCols ) }
+    , data( nullptr )
+  {
+    const std::size_t align = ( detected_cpu_caches().line_size > 64 ) ? detected_cpu_caches().line_size : 64;
+    std::size_t space = std::size_t(nRows) * info.rowSize * sizeof(T) + align;
+    raw.reset( new (std::nothrow) unsigned char[space] );
+    void * p = raw.get();
+    if ( p )
+      data = static_cast<T *>( std::align( align, space - align, p, space ) );
+  }
+
+  padded_matrix() = delete;
+  padded_matrix( const padded_matrix<T> & ) = delete;
+  padded_matrix<T> & operator=( const padded_matrix<T> & ) = delete;
+
+  ALWAYS_INLINE T * row( unsigned r ) { return &data[std::size_t(r) * info.rowSize]; }
+  ALWAYS_INLINE const T * row( unsigned r ) const { return &data[std::size_t(r) * info.rowSize]; }
+
+  mat_info info;
+  T * data;
+
+private:
+  std::unique_ptr<unsigned char[]> raw;
+};
+
+}
@@ -0,0 +1,440 @@
+#pragma once
+
+// multithreaded transpose: large transposes are memory bound - one core can't saturate the memory bandwidth.
+//   parallel_transpose() partitions the matrix into square blocks - in multiples of the kernel size -
+//   which the threads of a persistent thread_pool transpose with the single threaded kernels.
+//   each thread starts with a contiguous range of blocks and steals blocks from the other ranges, when done.
+//   parallel_cache_oblivious_*() run the first levels of the cache oblivious recursion as tasks
+
+#include "transpose_dispatch.hpp"
+#include "transpose_cache_oblivious.hpp"
+#include "transpose_inplace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+
+namespace transpose
+{
+
+// persistent pool of worker threads for parallel_for(): the calling thread is one of the size() threads.
+//   the items get distributed in contiguous ranges, one per thread - finished threads steal from the others.
+//   calls from different threads get serialized. parallel_for() must not be nested.
+//   with numa, the threads get bound to the NUMA nodes in contiguous groups - and steal only within their node:
+//   the contiguous range of items of a node's threads stays on that node
+class thread_pool
+{
+public:
+  // nThreads = 0 uses all hardware threads
+  explicit thread_pool( unsigned nThreads = 0, bool numa = false )
+  {
+    start( nThreads, numa );
+  }
+
+  ~thread_pool()
+  {
+    stop();
+  }
+
+  thread_pool( const thread_pool & ) = delete;
+  thread_pool & operator=( const thread_pool & ) = delete;
+
+  // #threads, including the calling thread
+  unsigned size() const
+  {
+    return nThreads;
+  }
+
+  // #NUMA nodes, which the threads are bound to: 1 without numa
+  unsigned num_nodes() const
+  {
+    return nNodes;
+  }
+
+  // index into detected_numa_nodes() of thread t. the calling thread 0 belongs to node 0 - but isn't bound:
+  //   call from a thread on the first node
+  unsigned thread_node( unsigned t ) const
+  {
+    return unsigned( std::size_t(t) * nNodes / nThreads );
+  }
+
+  // restarts with nThreads threads; 0 uses all hardware threads
+  void resize( unsigned nThreads_, bool numa = false )
+  {
+    std::lock_guard<std::mutex> call( call_mtx );
+    stop();
+    start( nThreads_, numa );
+  }
+
+  // calls fn( k ) for each item k in 0 .. nItems-1 - in any order, on any thread. returns, when all are done
+  template <class FN>
+  void parallel_for( unsigned nItems, FN &&fn )
+  {
+    using F = typename std::remove_reference<FN>::type;
+    run( nItems, [] ( void * ctx, unsigned k ) { ( *static_cast<F *>(ctx) )( k ); }, &fn );
+  }
+
+private:
+  using item_fn = void (*)( void * ctx, unsigned k );
+
+  // range of items, from which the owner and thieves take from the front
+  struct alignas(64) item_range
+  {
+    std::atomic<unsigned> next;
+    unsigned end;
+  };
+
+  void start( unsigned n, bool numa )
+  {
+    if ( !n )
+      n = std::thread::hardware_concurrency();
+    nThreads = n ? n : 1;
+    const std::vector<numa_node> &nodes = detected_numa_nodes();
+    nNodes = ( numa && nodes.size() > 1 ) ? unsigned( nodes.size() ) : 1;
+    if ( nNodes > nThreads )
+      nNodes = nThreads;
+    ranges.reset( new item_range[nThreads] );
+    quit = false;
+    for ( unsigned t = 1; t < nThreads; ++t ) {
+      workers.emplace_back( [this, t, gen = generation] () { worker( t, gen ); } );
+      if ( nNodes > 1 )
+        bind( workers.back(), nodes[ thread_node( t ) ].cpus );
+    }
+  }
+
+  // restricts the thread to the cpus - only on Linux
+  static void bind( std::thread &th, const std::vector<unsigned> &cpus )
+  {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO( &set );
+    for ( unsigned c : cpus )
+      if ( c < CPU_SETSIZE )
+        CPU_SET( c, &set );
+    pthread_setaffinity_np( th.native_handle(), sizeof(set), &set );
+#else
+    (void)th;
+    (void)cpus;
+#endif
+  }
+
+  void stop()
+  {
+    {
+      std::lock_guard<std::mutex> lk( mtx );
+      quit = true;
+    }
+    cv_start.notify_all();
+    for ( std::thread &w : workers )
+      w.join();
+    workers.clear();
+  }
+
+  void run( unsigned nItems, item_fn fn, void * ctx )
+  {
+    std::lock_guard<std::mutex> call( call_mtx );
+    const unsigned n = nThreads;
+    if ( n == 1 || nItems <= 1 ) {
+      for ( unsigned k = 0; k < nItems; ++k )
+        fn( ctx, k );
+      return;
+    }
+    for ( unsigned t = 0; t < n; ++t ) {
+      ranges[t].next.store( unsigned( std::size_t(nItems) * t / n ), std::memory_order_relaxed );
+      ranges[t].end = unsigned( std::size_t(nItems) * ( t + 1 ) / n );
+    }
+    {
+      std::lock_guard<std::mutex> lk( mtx );
+      job_fn = fn;
+      job_ctx = ctx;
+      pending = n - 1;
+      ++generation;
+    }
+    cv_start.notify_all();
+    work( 0 );
+    std::unique_lock<std::mutex> lk( mtx );
+    cv_done.wait( lk, [this] () { return pending == 0; } );
+  }
+
+  // own range first, then stealing from the following ones - of the same node
+  void work( unsigned self )
+  {
+    const unsigned n = nThreads;
+    const unsigned node = thread_node( self );
+    for ( unsigned v = 0; v < n; ++v ) {
+      if ( nNodes > 1 && thread_node( ( self + v ) % n ) != node )
+        continue;
+      item_range &r = ranges[ ( self + v ) % n ];
+      for ( unsigned k = r.next.fetch_add( 1, std::memory_order_relaxed ); k < r.end;
+            k = r.next.fetch_add( 1, std::memory_order_relaxed ) )
+        job_fn( job_ctx, k );
+    }
+  }
+
+  void worker( unsigned self, unsigned seen )
+  {
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lk( mtx );
+        cv_start.wait( lk, [this, seen] () { return quit || generation != seen; } );
+        if ( quit )
+          return;
+        seen = generation;
+      }
+      work( self );
+      std::lock_guard<std::mutex> lk( mtx );
+      if ( --pending == 0 )
+        cv_done.notify_one();
+    }
+  }
+
+  unsigned nThreads = 1;
+  unsigned nNodes = 1;
+  std::vector<std::thread> workers;
+  std::unique_ptr<item_range[]> ranges;
+  std::mutex call_mtx;
+  std::mutex mtx;
+  std::condition_variable cv_start;
+  std::condition_variable cv_done;
+  unsigned generation = 0;
+  unsigned pending = 0;
+  bool quit = false;
+  item_fn job_fn = nullptr;
+  void * job_ctx = nullptr;
+};
+
+
+// the pool of parallel_transpose(), started at first call with all hardware threads.
+//   change the thread count - or the NUMA binding - with default_thread_pool().resize( n, numa )
+inline thread_pool & default_thread_pool()
+{
+  static thread_pool pool;
+  return pool;
+}
+
+
+// transpose with the threads of pool: in square blocks of the blocking's L2 super-blocks,
+//   halved down to L1 blocks, while there are less than 4 blocks per thread.
+//   the kernel variant gets selected once, as in transpose() - for the whole matrix:
+//   streaming stores, aligned, peeling to aligned or unaligned kernels. the blocks stay aligned.
+//   with a NUMA pool, the blocks are in output order: each node writes a contiguous band of output rows -
+//   band j of pool.num_nodes() is placed on node j by first touch, see first_touch()
+template <class T, bool CONJUGATE = false>
+HEDLEY_NO_THROW
+static void parallel_transpose(
+  const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+  const mat_info &out, NO_ESCAPE T * RESTRICT pout,
+  thread_pool &pool = default_thread_pool() )
+{
+  static const dispatch_entry * const e = std::is_trivially_copyable<T>::value
+    ? dispatch_select( sizeof(T), CONJUGATE ) : nullptr;
+  if ( !e || pool.size() <= 1 ) {
+    transpose<T, CONJUGATE>( in, pin, out, pout );
+    return;
+  }
+
+  const unsigned K = e->kernel_sz;
+  const block_sizes bs = detected_block_sizes( sizeof(T), K );
+  const unsigned N = in.nRows, M = in.nCols;
+  unsigned side = K * bs.l2;
+  auto num_blocks = [N, M] ( unsigned s ) { return ( (N + s - 1) / s ) * ( (M + s - 1) / s ); };
+  while ( side > K * bs.l1 && num_blocks( side ) < 4 * pool.size() )
+    side = ( side / 2 > K * bs.l1 ) ? K * ( side / ( 2 * K ) ) : K * bs.l1;
+
+  const bool use_in = ( in.nRows < in.nCols );
+  const std::size_t out_bytes = std::size_t(out.nRows) * out.rowSize * sizeof(T);
+  const bool aligned = e->aa_in && e->aa_possible( in, pin, out, pout );
+  raw_transpose_fn fn;
+  if ( aligned && e->nt_in && out_bytes >= streaming_store_threshold() )
+    fn = e->nt_in;
+  else if ( aligned )
+    fn = use_in ? e->aa_in : e->aa_out;
+  else if ( e->pa_in )
+    fn = use_in ? e->pa_in : e->pa_out;
+  else
+    fn = use_in ? e->uu_in : e->uu_out;
+
+  // blocks in input order: each thread's range starts with contiguous input rows
+  const unsigned nBlockCols = ( M + side - 1 ) / side, nBlockRows = ( N + side - 1 ) / side;
+  const bool out_order = ( pool.num_nodes() > 1 );
+  pool.parallel_for( num_blocks( side ), [&] ( unsigned k ) {
+    const unsigned R0 = ( out_order ? k % nBlockRows : k / nBlockCols ) * side;
+    const unsigned C0 = ( out_order ? k / nBlockRows : k % nBlockCols ) * side;
+    const unsigned nR = ( N - R0 < side ) ? N - R0 : side, nC = ( M - C0 < side ) ? M - C0 : side;
+    fn( mat_info { nR, nC, in.rowSize }, &pin[std::size_t(R0) * in.rowSize + C0],
+      mat_info { nC, nR, out.rowSize }, &pout[std::size_t(C0) * out.rowSize + R0] );
+  } );
+}
+
+
+// pre-faults the pages of the output - before the first write of a NUMA unaware producer or the transpose:
+//   thread t touches the output rows [ t * nRows / size(), (t+1) * nRows / size() ) of the pool's threads
+//   - which are the bands of the nodes with a NUMA pool. reads and writes back the first element of the row
+//   in each page - without changing the contents
+template <class T>
+HEDLEY_NO_THROW
+static void first_touch(
+  const mat_info &out, NO_ESCAPE T * RESTRICT pout,
+  thread_pool &pool = default_thread_pool() )
+{
+  constexpr std::size_t PAGE = 4096;
+  const unsigned n = pool.size();
+  pool.parallel_for( n, [&] ( unsigned t ) {
+    const unsigned r0 = unsigned( std::size_t(out.nRows) * t / n ), r1 = unsigned( std::size_t(out.nRows) * ( t + 1 ) / n );
+    for ( unsigned r = r0; r < r1; ++r ) {
+      volatile unsigned char * row = reinterpret_cast<volatile unsigned char *>( &pout[std::size_t(r) * out.rowSize] );
+      const std::size_t bytes = std::size_t(out.nCols) * sizeof(T);
+      for ( std::size_t b = 0; b < bytes; b += PAGE - ( reinterpret_cast<std::uintptr_t>(row + b) % PAGE ) )
+        row[b] = row[b];
+    }
+  } );
+}
+
+
+// sub-matrix of the cache oblivious recursion
+struct co_block
+{
+  unsigned row_off;
+  unsigned col_off;
+  unsigned nRows;
+  unsigned nCols;
+};
+
+// the recursion of cache_oblivious_in() / _out() - down to blocks of at most cutoff elements,
+//   which become the tasks. the tasks are in the recursion's order: the contiguous range of each thread
+//   is a few subtrees of the recursion - keeping it's locality
+inline void co_split(
+  std::vector<co_block> &tasks,
+  const unsigned row_off, const unsigned col_off,
+  const unsigned nRows, const unsigned nCols, const std::size_t cutoff )
+{
+  if ( std::size_t(nRows) * nCols <= cutoff || ( nRows <= 1 && nCols <= 1 ) ) {
+    tasks.push_back( co_block { row_off, col_off, nRows, nCols } );
+    return;
+  }
+  if( nRows >= nCols ) {
+    const unsigned halfRows = nRows / 2U;
+    co_split( tasks, row_off, col_off, halfRows, nCols, cutoff );
+    co_split( tasks, row_off +halfRows, col_off, nRows - halfRows, nCols, cutoff );
+  } else {
+    const unsigned halfCols = nCols / 2U;
+    co_split( tasks, row_off, col_off, nRows, halfCols, cutoff );
+    co_split( tasks, row_off, col_off +halfCols, nRows, nCols - halfCols, cutoff );
+  }
+}
+
+// elements per task: 8 tasks per thread - for the stealing - but not below 64 x 64 elements,
+//   where the overhead of a task would dominate
+HEDLEY_CONST
+inline std::size_t co_task_cutoff( const std::size_t nElems, const unsigned nThreads )
+{
+  constexpr std::size_t MIN_TASK = 64 * 64;
+  const std::size_t c = nElems / ( 8 * std::size_t(nThreads) );
+  return ( c > MIN_TASK ) ? c : MIN_TASK;
+}
+
+
+// cache_oblivious_in() with the threads of pool: fork-join of the recursion above co_task_cutoff()
+template <class T, class U, bool CONJUGATE = false>
+HEDLEY_NO_THROW
+static void parallel_cache_oblivious_in(
+  const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+  const mat_info &out, NO_ESCAPE U * RESTRICT pout,
+  thread_pool &pool = default_thread_pool() )
+{
+  const mats_info<T,U> io {
+    pin, pout,
+    in.nRows, in.nCols, in.rowSize,
+    out.nRows, out.nCols, out.rowSize
+  };
+  std::vector<co_block> tasks;
+  co_split( tasks, 0, 0, in.nRows, in.nCols, co_task_cutoff( std::size_t(in.nRows) * in.nCols, pool.size() ) );
+  pool.parallel_for( unsigned( tasks.size() ), [&] ( unsigned k ) {
+    const co_block &b = tasks[k];
+    cache_oblivious_in<T, U, CONJUGATE>( io, b.row_off, b.col_off, b.nRows, b.nCols );
+  } );
+}
+
+// cache_oblivious_out() with the threads of pool: fork-join of the recursion above co_task_cutoff()
+template <class T, class U, bool CONJUGATE = false>
+HEDLEY_NO_THROW
+static void parallel_cache_oblivious_out(
+  const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+  const mat_info &out, NO_ESCAPE U * RESTRICT pout,
+  thread_pool &pool = default_thread_pool() )
+{
+  const mats_info<T,U> io {
+    pin, pout,
+    in.nRows, in.nCols, in.rowSize,
+    out.nRows, out.nCols, out.rowSize
+  };
+  std::vector<co_block> tasks;
+  co_split( tasks, 0, 0, out.nRows, out.nCols, co_task_cutoff( std::size_t(out.nRows) * out.nCols, pool.size() ) );
+  pool.parallel_for( unsigned( tasks.size() ), [&] ( unsigned k ) {
+    const co_block &b = tasks[k];
+    cache_oblivious_out<T, U, CONJUGATE>( io, b.row_off, b.col_off, b.nRows, b.nCols );
+  } );
+}
+
+template <class T, class U, bool CONJUGATE = false>
+HEDLEY_NO_THROW
+static void parallel_cache_oblivious_meta(
+  const mat_info &in, NO_ESCAPE const T * RESTRICT pin,
+  const mat_info &out, NO_ESCAPE U * RESTRICT pout,
+  thread_pool &pool = default_thread_pool() )
+{
+  if ( in.nRows < in.nCols )
+    parallel_cache_oblivious_in<T, U, CONJUGATE>( in, pin, out, pout, pool );
+  else
+    parallel_cache_oblivious_out<T, U, CONJUGATE>( in, pin, out, pout, pool );
+}
+
+
+// in-place transpose of the square n x n matrix with the threads of pool, see transpose_inplace():
+//   the items are the steps of transpose_inplace() - the diagonal tile or a chunk of tile pairs.
+//   the elements beyond the full tiles get swapped afterwards by the calling thread
+template <class T, bool CONJUGATE = false>
+HEDLEY_NO_THROW
+static void parallel_transpose_inplace(
+  const unsigned n, NO_ESCAPE T * p, const unsigned rowSize,
+  thread_pool &pool = default_thread_pool() )
+{
+  bool aligned = false;
+  const dispatch_entry * e = inplace_square_kernel<T, CONJUGATE>( p, rowSize, aligned );
+  const unsigned nT = e ? n / e->kernel_sz : 0;
+  if ( pool.size() <= 1 || nT < 2 ) {
+    transpose_inplace<T, CONJUGATE>( n, p, rowSize );
+    return;
+  }
+
+  // first step of each tile row
+  std::vector<unsigned> row_start( nT + 1, 0 );
+  for ( unsigned i = 0; i < nT; ++i )
+    row_start[i + 1] = row_start[i] + inplace_square_row_steps( i, nT );
+  pool.parallel_for( row_start[nT], [&] ( unsigned k ) {
+    const unsigned i = unsigned( std::upper_bound( row_start.begin(), row_start.end(), k ) - row_start.begin() ) - 1;
+    const unsigned s = k - row_start[i];
+    if ( !s ) {
+      inplace_square_step<T>( *e, aligned, p, rowSize, i, i, 1 );
+      return;
+    }
+    const unsigned j0 = i + 1 + ( s - 1 ) * INPLACE_CHUNK;
+    inplace_square_step<T>( *e, aligned, p, rowSize, i, j0, ( nT - j0 < INPLACE_CHUNK ) ? nT - j0 : INPLACE_CHUNK );
+  } );
+  inplace_square_tails<T, CONJUGATE>( n, p, rowSize, nT * e->kernel_sz );
+}
+
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+// permutation of the axes of N-dimensional arrays, e.g. [batch][rows][cols] -> [cols][batch][rows]:
+//   axes of size 1 get dropped and axes, which are nested contiguously in input and output, get fused.
+//   the axes with unit stride in input and output then form a 2D transpose at the core -
+//   which a plan transposes with the SIMD kernels for each index of the remaining outer axes.
+//   with small cores, the innermost outer axis is a batch for transpose_batch().
+//   without a transpose at the core, the innermost axis gets copied
+
+#include "transpose_defs.hpp"
+#include "transpose_dispatch.hpp"
+#include "transpose_plan.hpp"
+#include "transpose_batch.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <complex>
+#include <type_traits>
+
+
+namespace transpose
+{
+
+static constexpr unsigned PERMUTE_MAX_DIMS = 8;
+
+
+// one axis of the permutation: size and strides in elements of input and output
+struct permute_dim
+{
+  std::size_t n;
+  std::size_t is;
+  std::size_t os;
+};
+
+
+// the axes of a permutation after dropping and fusing: in input order.
+//   in / out index the axes with unit stride in input / output - or nDims without
+struct permute_dims
+{
+  unsigned nDims;
+  unsigned in;
+  unsigned out;
+  permute_dim d[PERMUTE_MAX_DIMS];
+};
+
+
+// axes of the permutation: output axis k is input axis axes[k] - with the shape of the input.
+//   returns false for nDims > PERMUTE_MAX_DIMS or when axes isn't a permutation
+inline bool calc_permute_dims(
+  const unsigned nDims, const std::size_t * shape, const std::size_t * strides_in,
+  const unsigned * axes, const std::size_t * strides_out, permute_dims &p )
+{
+  if ( nDims > PERMUTE_MAX_DIMS )
+    return false;
+  std::size_t os[PERMUTE_MAX_DIMS] = { 0 };
+  bool used[PERMUTE_MAX_DIMS] = { false };
+  for ( unsigned k = 0; k < nDims; ++k ) {
+    if ( axes[k] >= nDims || used[axes[k]] )
+      return false;
+    used[axes[k]] = true;
+    os[axes[k]] = strides_out[k];
+  }
+
+  p.nDims = 0;
+  for ( unsigned a = 0; a < nDims; ++a ) {
+    if ( !shape[a] ) {   // empty array
+      p.nDims = 1;
+      p.d[0] = permute_dim { 0, 1, 1 };
+      break;
+    }
+    if ( shape[a] == 1 )
+      continue;
+    const permute_dim d { shape[a], strides_in[a], os[a] };
+    // fuse with the previous axis, when that is nested contiguously around this one
+    permute_dim * prev = p.nDims ? &p.d[p.nDims - 1] : nullptr;
+    if ( prev && prev->is == d.n * d.is && prev->os == d.n * d.os )
+      *prev = permute_dim { prev->n * d.n, d.is, d.os };
+    else
+      p.d[p.nDims++] = d;
+  }
+
+  p.in = p.out = p.nDims;
+  for ( unsigned a = 0; a < p.nDims; ++a ) {
+    if ( p.d[a].is == 1 && p.in == p.nDims )
+      p.in = a;
+    if ( p.d[a].os == 1 && p.out == p.nDims )
+      p.out = a;
+  }
+  return true;
+}
+
+
+// copy of the innermost axis dim: n elements with strides is / os
+template <class T, bool CONJUGATE>
+HEDLEY_NO_THROW
+static void permute_copy( const permute_dim &dim, const T * RESTRICT pin, T * RESTRICT pout )
+{
+  if ( dim.is == 1 && dim.os == 1 && !CONJUGATE ) {
+    std::memcpy( pout, pin, dim.n * sizeof(T) );
+    return;
+  }
+  for ( std::size_t k = 0; k < dim.n; ++k ) {
+    if constexpr ( CONJUGATE )
+      pout[k * dim.os] = std::conj( pin[k * dim.is] );
+    else
+      pout[k * dim.os] = pin[k * dim.is];
+  }
+}
+
+
+// calls fn( in_off, out_off ) for each index of the axes of p - except the axes with the bits in skip.
+//   the last axis of the input runs fastest
+template <class FN>
+static void permute_outer( const permute_dims &p, const unsigned skip, FN &&fn )
+{
+  unsigned ax[PERMUTE_MAX_DIMS];
+  unsigned nAx = 0;
+  for ( unsigned a = 0; a < p.nDims; ++a )
+    if ( !( skip & ( 1U << a ) ) )
+      ax[nAx++] = a;
+
+  std::size_t idx[PERMUTE_MAX_DIMS] = { 0 };
+  std::size_t in_off = 0, out_off = 0;
+  while ( true ) {
+    fn( in_off, out_off );
+    unsigned k = nAx;
+    while ( true ) {
+      if ( !k )
+        return;
+      const permute_dim &d = p.d[ax[--k]];
+      in_off += d.is;
+      out_off += d.os;
+      if ( ++idx[k] < d.n )
+        break;
+      in_off -= idx[k] * d.is;
+      out_off -= idx[k] * d.os;
+      idx[k] = 0;
+    }
+  }
+}
+
+
+// permutes the axes of the array at pin into pout: output axis k is input axis axes[k].
+//   shape is the input's shape, strides_in per input axis, strides_out per output axis - in elements.
+//   input and output must not overlap. returns false for more than PERMUTE_MAX_DIMS axes,
+//   invalid axes or strides of the 2D transpose at the core, which don't fit into an unsigned.
+//   CONJUGATE is only supported for std::complex<float or double>
+template <class T, bool CONJUGATE = false>
+HEDLEY_NO_THROW
+static bool permute(
+  const unsigned nDims, const std::size_t * shape, const std::size_t * strides_in,
+  const unsigned * axes, const std::size_t * strides_out,
+  NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout )
+{
+  static_assert( !CONJUGATE
+    || std::is_same<T, std::complex<float> >::value
+    || std::is_same<T, std::complex<double> >::value
+    , "CONJUGATE is only supported by permute for std::complex<float or double>" );
+
+  permute_dims p;
+  if ( !calc_permute_dims( nDims, shape, strides_in, axes, strides_out, p ) )
+    return false;
+  if ( !p.nDims ) {  // single element
+    pout[0] = pin[0];
+    if constexpr ( CONJUGATE )
+      pout[0] = std::conj( pout[0] );
+    return true;
+  }
+  if ( !p.d[0].n )
+    return true;
+
+  if ( p.in == p.nDims || p.out == p.nDims || p.in == p.out ) {
+    // no transpose at the core: copy the innermost axis - the one with unit stride, if any
+    const unsigned c = ( p.out < p.nDims ) ? p.out : ( p.in < p.nDims ) ? p.in : p.nDims - 1;
+    permute_outer( p, 1U << c, [&] ( std::size_t i, std::size_t o ) {
+      permute_copy<T, CONJUGATE>( p.d[c], &pin[i], &pout[o] );
+    } );
+    return true;
+  }
+
+  // 2D transpose at the core: the rows of the input are along the output's unit stride axis
+  const permute_dim &r = p.d[p.out], &c = p.d[p.in];
+  if ( r.n > 0xFFFFFFFFU || c.n > 0xFFFFFFFFU || r.is > 0xFFFFFFFFU || c.os > 0xFFFFFFFFU )
+    return false;
+  const mat_info in { unsigned(r.n), unsigned(c.n), unsigned(r.is) };
+  const mat_info out { unsigned(c.n), unsigned(r.n), unsigned(c.os) };
+  const unsigned core = ( 1U << p.in ) | ( 1U << p.out );
+
+  // small cores: the innermost other axis is the batch
+  static const dispatch_entry * const e = std::is_trivially_copyable<T>::value
+    ? dispatch_select( sizeof(T), CONJUGATE ) : nullptr;
+  unsigned b = p.nDims;
+  while ( b && ( core & ( 1U << ( b - 1 ) ) ) )
+    --b;
+  if ( e && b && ( r.n < e->kernel_sz || c.n < e->kernel_sz ) && p.d[b - 1].n <= 0xFFFFFFFFU ) {
+    const permute_dim &bd = p.d[b - 1];
+    permute_outer( p, core | ( 1U << ( b - 1 ) ), [&] ( std::size_t i, std::size_t o ) {
+      transpose_batch<T, CONJUGATE>( in, &pin[i], bd.is, out, &pout[o], bd.os, unsigned(bd.n) );
+    } );
+    return true;
+  }
+
+  const plan<T, CONJUGATE> pl( in, out );
+  permute_outer( p, core, [&] ( std::size_t i, std::size_t o ) {
+    pl.execute( &pin[i], &pout[o] );
+  } );
+  return true;
+}
+
+}
@@ -0,0 +1,182 @@
+
+#pragma once
+
+// reusable plan for one shape and pair of row sizes:
+//   kernel, order, the grid of full kernels and the tail regions are computed once, at construction.
+//   execute() transposes with new pointers at minimal overhead
+
+#include "transpose_defs.hpp"
+#include "transpose_dispatch.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <complex>
+#include <type_traits>
+
+
+namespace transpose
+{
+
+template <class T, bool CONJUGATE = false>
+class plan
+{
+  static_assert( !CONJUGATE
+    || std::is_same<T, std::complex<float> >::value
+    || std::is_same<T, std::complex<double> >::value
+    , "CONJUGATE is only supported by plan for std::complex<float or double>" );
+
+public:
+  plan( const mat_info &in_, const mat_info &out_ )
+    : in( in_ ), out( out_ )
+  {
+    e = std::is_trivially_copyable<T>::value ? dispatch_select( sizeof(T), CONJUGATE ) : nullptr;
+    use_in = ( in.nRows < in.nCols );
+    if ( !e || !e->tiles_uu_in )
+      return;  // execute() transposes without schedule
+
+    // unaligned grid and tails - see caware_kernel::uu_out() / uu_in()
+    const unsigned K = e->kernel_sz;
+    const unsigned N = use_in ? in.nRows : out.nRows;
+    const unsigned M = use_in ? in.nCols : out.nCols;
+    const unsigned Nf = K * ( N / K ), Mf = K * ( M / K );
+    tiles_uu = use_in ? e->tiles_uu_in : e->tiles_uu_out;
+    nTileRows = N / K;
+    nTileCols = M / K;
+    // tails by full kernels overlapping the grid, where N / M >= K - see caware_kernel::tails_out() / tails_in()
+    auto region = [this] ( unsigned r, unsigned c, unsigned nR, unsigned nC, bool kernels ) {
+      tails[nTails++] = use_in
+        ? tail_region { std::size_t(r) * in.rowSize + c, std::size_t(c) * out.rowSize + r, nR, nC, kernels }
+        : tail_region { std::size_t(c) * in.rowSize + r, std::size_t(r) * out.rowSize + c, nR, nC, kernels };
+    };
+    if ( Mf < M && Nf ) { // tail columns of the full rows
+      if ( Mf )
+        region( 0, M - K, N / K, 1, true );
+      else
+        region( 0, 0, Nf, M, false );
+    }
+    if ( Nf < N && M ) {  // tail rows
+      if ( Nf && Mf ) {
+        region( N - K, 0, 1, M / K, true );
+        if ( Mf < M )     // corner
+          region( N - K, M - K, 1, 1, true );
+      }
+      else
+        region( Nf, 0, N - Nf, M, false );
+    }
+
+    // aligned grid covers the rounded up matrix - see caware_kernel::aa_possible()
+    const unsigned out_mod = (out.rowSize % K) | (out.nRows % K);
+    const unsigned in_mod = (in.rowSize % K) | (in.nRows % K);
+    if ( e->tiles_aa_in && !out_mod && !in_mod ) {
+      tiles_aa = use_in ? e->tiles_aa_in : e->tiles_aa_out;
+      nTileRowsAA = ( N + K - 1 ) / K;
+      nTileColsAA = ( M + K - 1 ) / K;
+      if ( e->tiles_nt_in && std::size_t(out.nRows) * out.rowSize * sizeof(T) >= streaming_store_threshold() ) {
+        // streamed output lines don't stay in cache: input order is faster, see transpose()
+        tiles_aa = e->tiles_nt_in;
+        nTileRowsAA = ( in.nRows + K - 1 ) / K;
+        nTileColsAA = ( in.nCols + K - 1 ) / K;
+      }
+      aa_mask = std::uintptr_t( K * sizeof(T) - 1 );
+    }
+
+    // blocked traversal of the grid - not with the streaming stores, see transpose()
+    if ( e->bk_in && std::size_t(out.nRows) * out.rowSize * sizeof(T) > blocking_threshold() ) {
+      blocked = true;
+      bs = detected_block_sizes( sizeof(T), K );
+    }
+
+    // row sizes in multiples of K, but pointers missing the alignment - or #rows not in multiples of K:
+    //   peeling to the aligned kernel, see transpose(). bk_*() peel themselves
+    if ( e->pa_in && !( in.rowSize % K ) && !( out.rowSize % K ) ) {
+      if ( blocked )
+        peeled = use_in ? e->bk_in : e->bk_out;
+      else
+        peeled = use_in ? e->pa_in : e->pa_out;
+    }
+  }
+
+  HEDLEY_NO_THROW
+  void execute( NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout ) const
+  {
+    if ( tiles_aa && !( ( reinterpret_cast<std::uintptr_t>(pin) | reinterpret_cast<std::uintptr_t>(pout) ) & aa_mask ) ) {
+      grid( tiles_aa, pin, pout, nTileRowsAA, nTileColsAA );
+      return;
+    }
+    if ( peeled ) {
+      peeled( in, pin, out, pout );
+      return;
+    }
+    if ( tiles_uu ) {
+      grid( tiles_uu, pin, pout, nTileRows, nTileCols );
+      for ( unsigned k = 0; k < nTails; ++k ) {
+        const tail_region &t = tails[k];
+        if ( t.kernels )
+          tiles_uu( pin + t.in_off, pout + t.out_off, t.nRows, t.nCols, in.rowSize, out.rowSize );
+        else if ( use_in )
+          tail_transpose_in<T, T, CONJUGATE>( pin + t.in_off, pout + t.out_off, t.nRows, t.nCols, in.rowSize, out.rowSize );
+        else
+          tail_transpose_out<T, T, CONJUGATE>( pin + t.in_off, pout + t.out_off, t.nRows, t.nCols, in.rowSize, out.rowSize );
+      }
+      return;
+    }
+    if ( e )
+      ( use_in ? e->uu_in : e->uu_out )( in, pin, out, pout );
+    else
+      transpose<T, CONJUGATE>( in, pin, out, pout );
+  }
+
+  // name of the dispatched kernel; nullptr for types without
+  const char * kernel_name() const { return e ? e->name : nullptr; }
+  // iterating linearly through input matrix indices - or the output's
+  bool in_order() const { return use_in; }
+  const mat_info & in_info() const { return in; }
+  const mat_info & out_info() const { return out; }
+
+private:
+  HEDLEY_NO_THROW
+  void grid( raw_tiles_fn tiles, NO_ESCAPE const T * RESTRICT pin, NO_ESCAPE T * RESTRICT pout,
+    const unsigned nTRows, const unsigned nTCols ) const
+  {
+    if ( !blocked || tiles == e->tiles_nt_in )
+      tiles( pin, pout, nTRows, nTCols, in.rowSize, out.rowSize );
+    else if ( use_in )
+      blocked_tiles_in( tiles, pin, pout, nTRows, nTCols, e->kernel_sz, in.rowSize, out.rowSize, bs );
+    else
+      blocked_tiles_out( tiles, pin, pout, nTRows, nTCols, e->kernel_sz, in.rowSize, out.rowSize, bs );
+  }
+
+  // offsets in elements of the region's first element in input / output matrix
+  //   #rows and #cols of the iterated matrix - or #tile rows and #tile cols of full kernels
+  struct tail_region
+  {
+    std::size_t in_off;
+    std::size_t out_off;
+    unsigned nRows;
+    unsigned nCols;
+    bool kernels;
+  };
+
+  mat_info in;
+  mat_info out;
+  const dispatch_entry * e = nullptr;
+  bool use_in = false;
+
+  raw_tiles_fn tiles_uu = nullptr;
+  unsigned nTileRows = 0;
+  unsigned nTileCols = 0;
+  unsigned nTails = 0;
+  tail_region tails[3];
+
+  raw_tiles_fn tiles_aa = nullptr;
+  unsigned nTileRowsAA = 0;
+  unsigned nTileColsAA = 0;
+  std::uintptr_t aa_mask = 0;
+
+  raw_transpose_fn peeled = nullptr;
+
+  bool blocked = false;
+  block_sizes bs { 1, 1 };
+};
+
+}
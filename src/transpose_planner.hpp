@@ -0,0 +1,349 @@
+
+#pragma once
+
+// autotuning planner: measures the candidate algorithms/kernels/orders once per
+//   (element size, conjugation, shape, row sizes, alignment)
+//   and remembers the fastest - like FFTW's planner, the knowledge is called "wisdom".
+//   wisdom can be saved to and loaded from a text file, to avoid measurement at each startup
+
+#include "transpose_defs.hpp"
+#include "transpose_dispatch.hpp"
+
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+
+namespace transpose
+{
+
+// wraps the generic algorithms for type erasure
+//   caware_in() / caware_out() do not support conjugation
+template <class T, bool CONJUGATE>
+struct raw_algo_wrapper
+{
+  static void naive_in( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    transpose::naive_in<T, T, CONJUGATE>( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void naive_out( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    transpose::naive_out<T, T, CONJUGATE>( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void cache_oblivious_in( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    transpose::cache_oblivious_in<T, T, CONJUGATE>( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void cache_oblivious_out( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    transpose::cache_oblivious_out<T, T, CONJUGATE>( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void caware_in( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    transpose::caware_in<T, T>( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+  static void caware_out( const mat_info &in, const void * pin, const mat_info &out, void * pout ) {
+    transpose::caware_out<T, T>( in, static_cast<const T *>(pin), out, static_cast<T *>(pout) );
+  }
+};
+
+
+struct plan_candidate
+{
+  std::string name;   // e.g. "naive_out" or "AVX_8x8x32_aa_in"
+  raw_transpose_fn fn;
+};
+
+
+template <unsigned ELEM_SZ, bool CONJUGATE>
+static void plan_generic_candidates( std::vector<plan_candidate> &c )
+{
+  using W = raw_algo_wrapper<typename dispatch_type<ELEM_SZ, CONJUGATE>::type, CONJUGATE>;
+  c.push_back( plan_candidate { "naive_in", W::naive_in } );
+  c.push_back( plan_candidate { "naive_out", W::naive_out } );
+  c.push_back( plan_candidate { "cache_oblivious_in", W::cache_oblivious_in } );
+  c.push_back( plan_candidate { "cache_oblivious_out", W::cache_oblivious_out } );
+  if ( !CONJUGATE ) {
+    c.push_back( plan_candidate { "caware_in", W::caware_in } );
+    c.push_back( plan_candidate { "caware_out", W::caware_out } );
+  }
+}
+
+
+// fills the candidates for the element size and conjugation
+//   with the aligned and streaming kernels, if aligned: from aa_possible() of the dispatched kernel
+//   and the kernel's peeling, blocked, bounce tile, cache oblivious and prefetching variants
+//   returns false for unsupported element size / conjugation
+inline bool plan_candidates(
+  std::vector<plan_candidate> &c, unsigned elemSize, bool conjugate, bool aligned )
+{
+  c.clear();
+  switch ( dispatch_index( elemSize ) * 2U + ( conjugate ? 1U : 0U ) ) {
+    case 0:   plan_generic_candidates< 1, false>( c );  break;
+    case 2:   plan_generic_candidates< 2, false>( c );  break;
+    case 4:   plan_generic_candidates< 4, false>( c );  break;
+    case 6:   plan_generic_candidates< 8, false>( c );  break;
+    case 7:   plan_generic_candidates< 8, true >( c );  break;
+    case 8:   plan_generic_candidates<16, false>( c );  break;
+    case 9:   plan_generic_candidates<16, true >( c );  break;
+    default:  return false;
+  }
+
+  const dispatch_entry * e = dispatch_select( elemSize, conjugate );
+  // the generic "caware" entry is already a candidate
+  if ( e && std::strcmp( e->name, "caware" ) ) {
+    const std::string k = e->name;
+    c.push_back( plan_candidate { k + "_uu_in", e->uu_in } );
+    c.push_back( plan_candidate { k + "_uu_out", e->uu_out } );
+    if ( aligned && e->aa_in ) {
+      c.push_back( plan_candidate { k + "_aa_in", e->aa_in } );
+      c.push_back( plan_candidate { k + "_aa_out", e->aa_out } );
+    }
+    if ( aligned && e->nt_in ) {
+      c.push_back( plan_candidate { k + "_nt_in", e->nt_in } );
+      c.push_back( plan_candidate { k + "_nt_out", e->nt_out } );
+    }
+    if ( !aligned && e->pa_in ) {
+      c.push_back( plan_candidate { k + "_pa_in", e->pa_in } );
+      c.push_back( plan_candidate { k + "_pa_out", e->pa_out } );
+    }
+    if ( e->bk_in ) {
+      c.push_back( plan_candidate { k + "_bk_in", e->bk_in } );
+      c.push_back( plan_candidate { k + "_bk_out", e->bk_out } );
+    }
+    if ( e->bt_in ) {
+      c.push_back( plan_candidate { k + "_bt_in", e->bt_in } );
+      c.push_back( plan_candidate { k + "_bt_out", e->bt_out } );
+    }
+    if ( e->co_in ) {
+      c.push_back( plan_candidate { k + "_co_in", e->co_in } );
+      c.push_back( plan_candidate { k + "_co_out", e->co_out } );
+    }
+    for ( unsigned v = 0; v < NUM_PREFETCH_VARIANTS && e->pf_in[v]; ++v ) {
+      // e.g. "AVX_8x8x32_pf8nta_in"
+      const std::string pf = k + "_pf" + std::to_string( prefetch_variants[v].distance )
+        + ( prefetch_variants[v].nta ? "nta" : "" );
+      c.push_back( plan_candidate { pf + "_in", e->pf_in[v] } );
+      c.push_back( plan_candidate { pf + "_out", e->pf_out[v] } );
+    }
+  }
+  return true;
+}
+
+
+class planner
+{
+public:
+  // number of timed repetitions per candidate: the minimum duration counts
+  unsigned measure_runs = 5;
+
+  planner() = default;
+  planner( const planner & ) = delete;
+  planner & operator=( const planner & ) = delete;
+
+  // returns the fastest transpose function for the given matrices - with the arguments of the call
+  //   unknown problems get measured - on the given buffers, like FFTW_MEASURE:
+  //   pout then already contains the transposed matrix
+  //   returns nullptr for unsupported element size / conjugation
+  //   thread safe: the measurement runs without the lock - when another thread measured
+  //   the same problem meanwhile, it's wisdom is kept
+  raw_transpose_fn plan(
+    unsigned elemSize, bool conjugate,
+    const mat_info &in, const void * pin,
+    const mat_info &out, void * pout,
+    const char ** name = nullptr, bool * executed = nullptr )
+  {
+    if ( executed )
+      *executed = false;
+    const unsigned k = dispatch_index( elemSize );
+    if ( k >= 5 || ( conjugate && k < 3 ) )
+      return nullptr;
+    const dispatch_entry * e = dispatch_select( elemSize, conjugate );
+    const bool aligned = e && e->aa_in && e->aa_possible( in, pin, out, pout );
+
+    const wisdom_key key { elemSize, conjugate ? 1U : 0U, in.nRows, in.nCols, in.rowSize, out.rowSize, aligned ? 1U : 0U };
+    std::unique_lock<std::mutex> lock( mtx );
+    auto it = wisdom.find( key );
+    if ( it != wisdom.end() && it->second.fn ) {
+      if ( name )
+        *name = it->second.name.c_str();
+      return it->second.fn;
+    }
+
+    std::vector<plan_candidate> c;
+    if ( !plan_candidates( c, elemSize, conjugate, aligned ) )
+      return nullptr;
+    if ( it != wisdom.end() ) {
+      // from loaded wisdom: resolve the name. a name unknown on this host requires measurement
+      for ( const plan_candidate & p : c ) {
+        if ( p.name == it->second.name ) {
+          it->second.fn = p.fn;
+          if ( name )
+            *name = it->second.name.c_str();
+          return p.fn;
+        }
+      }
+    }
+
+    lock.unlock();
+    const unsigned best = measure( c, in, pin, out, pout );
+    if ( executed )
+      *executed = true;
+    lock.lock();
+    wisdom_value & v = wisdom[ key ];
+    if ( !v.fn ) {
+      v.name = c[best].name;
+      v.fn = c[best].fn;
+    }
+    if ( name )
+      *name = v.name.c_str();
+    return v.fn;
+  }
+
+  template <class T, bool CONJUGATE = false>
+  raw_transpose_fn plan(
+    const mat_info &in, const T * pin,
+    const mat_info &out, T * pout,
+    const char ** name = nullptr, bool * executed = nullptr )
+  {
+    static_assert( !CONJUGATE
+      || std::is_same<T, std::complex<float> >::value
+      || std::is_same<T, std::complex<double> >::value
+      , "CONJUGATE is only supported by planner for std::complex<float or double>" );
+    if ( executed )
+      *executed = false;
+    if ( !std::is_trivially_copyable<T>::value )
+      return nullptr;
+    return plan( sizeof(T), CONJUGATE, in, pin, out, pout, name, executed );
+  }
+
+  // transpose with the planned function
+  //   types without candidates fall back to transpose() from transpose_dispatch.hpp
+  template <class T, bool CONJUGATE = false>
+  void transpose(
+    const mat_info &in, const T * pin,
+    const mat_info &out, T * pout )
+  {
+    bool executed = false;
+    raw_transpose_fn fn = plan<T, CONJUGATE>( in, pin, out, pout, nullptr, &executed );
+    if ( !fn )
+      ::transpose::transpose<T, CONJUGATE>( in, pin, out, pout );
+    else if ( !executed )
+      fn( in, pin, out, pout );
+  }
+
+  // text file with one line per problem:
+  //   <elemSize> <conjugate> <nRows> <nCols> <in rowSize> <out rowSize> <aligned> <candidate name>
+  bool save_wisdom( const char * filename ) const
+  {
+    std::ofstream f( filename );
+    if ( !f )
+      return false;
+    std::lock_guard<std::mutex> lock( mtx );
+    f << WISDOM_HEADER << "\n";
+    for ( const auto & w : wisdom ) {
+      const wisdom_key & k = w.first;
+      f << k.elemSize << " " << k.conjugate << " " << k.nRows << " " << k.nCols << " "
+        << k.inRowSize << " " << k.outRowSize << " " << k.aligned << " " << w.second.name << "\n";
+    }
+    f.flush();
+    return bool(f);
+  }
+
+  // merges the file's wisdom into the existing one. returns false, and merges nothing,
+  //   if the file can't be read or has an invalid format
+  bool load_wisdom( const char * filename )
+  {
+    std::ifstream f( filename );
+    if ( !f )
+      return false;
+    std::string header;
+    if ( !std::getline( f, header ) || header != WISDOM_HEADER )
+      return false;
+    std::map<wisdom_key, wisdom_value> loaded;
+    wisdom_key k;
+    wisdom_value v { std::string(), nullptr };
+    while ( f >> k.elemSize >> k.conjugate >> k.nRows >> k.nCols >> k.inRowSize >> k.outRowSize >> k.aligned >> v.name )
+      loaded[k] = v;
+    if ( !f.eof() )
+      return false;
+    std::lock_guard<std::mutex> lock( mtx );
+    for ( const auto & w : loaded )
+      wisdom[ w.first ] = w.second;
+    return true;
+  }
+
+  void forget_wisdom()
+  {
+    std::lock_guard<std::mutex> lock( mtx );
+    wisdom.clear();
+  }
+
+private:
+  static constexpr const char * WISDOM_HEADER = "libtranspose wisdom 1";
+
+  struct wisdom_key
+  {
+    unsigned elemSize;
+    unsigned conjugate;
+    unsigned nRows;
+    unsigned nCols;
+    unsigned inRowSize;
+    unsigned outRowSize;
+    unsigned aligned;
+
+    bool operator<( const wisdom_key &b ) const {
+      return std::tie( elemSize, conjugate, nRows, nCols, inRowSize, outRowSize, aligned )
+        < std::tie( b.elemSize, b.conjugate, b.nRows, b.nCols, b.inRowSize, b.outRowSize, b.aligned );
+    }
+  };
+
+  struct wisdom_value
+  {
+    std::string name;
+    raw_transpose_fn fn;  // nullptr until resolved, when loaded from file
+  };
+
+  // returns index of the fastest candidate
+  //   each timed run repeats the candidate, that it lasts some microseconds
+  unsigned measure(
+    const std::vector<plan_candidate> &c,
+    const mat_info &in, const void * pin,
+    const mat_info &out, void * pout ) const
+  {
+    using clock = std::chrono::steady_clock;
+    constexpr double MIN_RUN_NS = 20000.0;
+    unsigned best = 0;
+    double best_ns = 0.0;
+    for ( unsigned k = 0; k < c.size(); ++k ) {
+      // warm up and estimate the repetitions
+      auto t0 = clock::now();
+      c[k].fn( in, pin, out, pout );
+      double ns = double( std::chrono::duration_cast<std::chrono::nanoseconds>( clock::now() - t0 ).count() );
+      const unsigned reps = ( ns < MIN_RUN_NS ) ? unsigned( MIN_RUN_NS / ( ns + 1.0 ) ) + 1U : 1U;
+
+      double min_ns = 0.0;
+      for ( unsigned r = 0; r < measure_runs || !r; ++r ) {
+        t0 = clock::now();
+        for ( unsigned i = 0; i < reps; ++i )
+          c[k].fn( in, pin, out, pout );
+        ns = double( std::chrono::duration_cast<std::chrono::nanoseconds>( clock::now() - t0 ).count() ) / reps;
+        if ( !r || ns < min_ns )
+          min_ns = ns;
+      }
+      if ( !k || min_ns < best_ns ) {
+        best = k;
+        best_ns = min_ns;
+      }
+    }
+    return best;
+  }
+
+  std::map<wisdom_key, wisdom_value> wisdom;
+  mutable std::mutex mtx;
+};
+
+}
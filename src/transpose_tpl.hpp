@@ -7,9 +7,17 @@
 
 #include "transpose_cache_aware_kernels.hpp"
 
+#include "trans_kernel_AVX512_16x16x32bit.hpp"
+#include "trans_kernel_AVX512_8x8x64bit.hpp"
+#include "trans_kernel_AVX512_4x4x128bit.hpp"
+#include "trans_kernel_AVX2_16x16x8bit.hpp"
 #include "trans_kernel_AVX_8x8x32bit.hpp"
 #include "trans_kernel_AVX_4x4x32bit.hpp"
 #include "trans_kernel_SSE_4x4x32bit.hpp"
+#include "trans_kernel_NEON_16x16x8bit.hpp"
+#include "trans_kernel_NEON_8x8x16bit.hpp"
+#include "trans_kernel_NEON_4x4x32bit.hpp"
+#include "trans_kernel_NEON_4x4x64bit.hpp"
 
 #include "trans_kernel_SSE41_8x8x8bit_macros.hpp"
 #ifdef HAVE_SSE41_8x8x8_KERNEL
@@ -42,6 +50,9 @@
 #endif
 
 #include "trans_kernel_SSE2_8x8x16bit.hpp"
+#include "trans_kernel_SSE2_4x4x64bit.hpp"
+#include "trans_kernel_SSE2_4x4x128bit.hpp"
+#include "trans_kernel_AVX2_16x16x16bit.hpp"
 
 #include "trans_kernel_naive.hpp"
 